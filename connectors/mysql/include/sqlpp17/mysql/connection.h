@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sqlpp17/connection.h>
 #include <sqlpp17/result.h>
 #include <sqlpp17/statement.h>
+#include <sqlpp17/statement_registry.h>
 
 #include <sqlpp17/mysql/mysql.h>
 #include <sqlpp17/mysql/clause.h>
@@ -81,6 +82,63 @@ namespace sqlpp::mysql::detail
     }
   }
 
+  inline auto connect(const connection_config_t& config) -> unique_connection_ptr
+  {
+    detail::thread_init();
+
+    auto handle = unique_connection_ptr{mysql_init(nullptr)};
+    if (not handle)
+    {
+      throw sqlpp::exception("MySQL: could not init mysql data structure");
+    }
+
+    if (config.pre_connect)
+    {
+      config.pre_connect(handle.get());
+    }
+
+    if (config.ssl)
+    {
+      const auto& ssl = config.ssl.value();
+      mysql_ssl_set(handle.get(), ssl.key.c_str(), ssl.cert.c_str(), ssl.ca.empty() ? nullptr : ssl.ca.c_str(),
+                    ssl.caPath.empty() ? nullptr : ssl.caPath.c_str(),
+                    ssl.cipher.empty() ? nullptr : ssl.cipher.c_str());
+    }
+
+    if (!mysql_real_connect(handle.get(), config.host.empty() ? nullptr : config.host.c_str(),
+                            config.user.empty() ? nullptr : config.user.c_str(),
+                            config.password.empty() ? nullptr : config.password.c_str(), nullptr, config.port,
+                            config.unix_socket.empty() ? nullptr : config.unix_socket.c_str(), config.client_flag))
+    {
+      throw sqlpp::exception("MySQL: could not connect to server: " + std::string(mysql_error(handle.get())));
+    }
+
+    if (mysql_set_character_set(handle.get(), config.charset.c_str()))
+    {
+      throw sqlpp::exception("MySQL: can't set character set " + config.charset);
+    }
+
+    if (mysql_select_db(handle.get(), config.database.c_str()))
+    {
+      throw sqlpp::exception("MySQL: can't select database '" + config.database + "'");
+    }
+
+    if (config.post_connect)
+    {
+      config.post_connect(handle.get());
+    }
+
+    return handle;
+  }
+
+  // A statement of prepare_cached(), used by one prepared statement at a time
+  struct cached_statement_t
+  {
+    unique_prepared_statement_ptr handle;
+    bool in_use = false;
+  };
+
+  using statement_registry_t = ::sqlpp::statement_registry_t<cached_statement_t>;
 }  // namespace sqlpp::mysql::detail
 
 namespace sqlpp::mysql
@@ -99,6 +157,8 @@ namespace sqlpp::mysql
     using _debug_base = ::sqlpp::debug_base<Debug>;
 
     detail::unique_connection_ptr _handle;
+    // used if this connection is not pooled, declared after the handle, so that statements are closed first
+    detail::statement_registry_t _statements;
     bool _transaction_active = false;
 
     template <typename... Clauses>
@@ -116,57 +176,11 @@ namespace sqlpp::mysql
     {
     }
 
-    base_connection(const connection_config_t& config, Pool* connection_pool) : base_connection{config}
-    {
-      this->_connection_pool = connection_pool;
-    }
-
   public:
     base_connection() = delete;
-    base_connection(const connection_config_t& config) : _debug_base{config.debug}, _handle(mysql_init(nullptr))
+    base_connection(const connection_config_t& config) : _debug_base{config.debug}, _handle{detail::connect(config)}
     {
-      if (not _handle)
-      {
-        throw sqlpp::exception("MySQL: could not init mysql data structure");
-      }
-
-      if (config.pre_connect)
-      {
-        config.pre_connect(get());
-      }
-
-      if (config.ssl)
-      {
-        const auto& ssl = config.ssl.value();
-        mysql_ssl_set(_handle.get(), ssl.key.c_str(), ssl.cert.c_str(), ssl.ca.empty() ? nullptr : ssl.ca.c_str(),
-                      ssl.caPath.empty() ? nullptr : ssl.caPath.c_str(),
-                      ssl.cipher.empty() ? nullptr : ssl.cipher.c_str());
-      }
-
-      if (!mysql_real_connect(_handle.get(), config.host.empty() ? nullptr : config.host.c_str(),
-                              config.user.empty() ? nullptr : config.user.c_str(),
-                              config.password.empty() ? nullptr : config.password.c_str(), nullptr, config.port,
-                              config.unix_socket.empty() ? nullptr : config.unix_socket.c_str(), config.client_flag))
-      {
-        throw sqlpp::exception("MySQL: could not connect to server: " + std::string(mysql_error(_handle.get())));
-      }
-
-      if (mysql_set_character_set(_handle.get(), config.charset.c_str()))
-      {
-        throw sqlpp::exception("MySQL: can't set character set " + config.charset);
-      }
-
-      if (mysql_select_db(_handle.get(), config.database.c_str()))
-      {
-        throw sqlpp::exception("MySQL: can't select database '" + config.database + "'");
-      }
-
-      if (config.post_connect)
-      {
-        config.post_connect(_handle.get());
-      }
     }
-
     base_connection(const base_connection&) = delete;
     base_connection(base_connection&&) = default;
     base_connection& operator=(const base_connection&) = delete;
@@ -175,8 +189,15 @@ namespace sqlpp::mysql
     {
       if constexpr (not std::is_same_v<Pool, no_pool>)
       {
-        if (this->_connection_pool)
-          this->_connection_pool->put(std::move(_handle));
+        if (this->_connection_pool and _handle)
+        {
+          // idle connections must not keep unread results of cached statements
+          statements().for_each([](detail::cached_statement_t& cached) {
+            mysql_stmt_free_result(cached.handle.get());
+            mysql_stmt_reset(cached.handle.get());
+          });
+          this->_connection_pool->put(std::move(_handle), this->_pool_entry);
+        }
       }
     }
 
@@ -232,6 +253,50 @@ namespace sqlpp::mysql
       }
     }
 
+    // Like prepare(), but the native statement is kept in statements() and reused for the same SQL, also by later
+    // users of the same pooled connection. It is reset when handed out and when the prepared statement is destroyed.
+    // While it is in use, further prepared statements for the same SQL get a statement of their own.
+    template <typename... Clauses>
+    auto prepare_cached(const ::sqlpp::statement<Clauses...>& statement)
+    {
+      using Statement = ::sqlpp::statement<Clauses...>;
+      using _prepared_statement_t =
+          prepared_statement_t<result_type_of_t<Statement>, parameters_of_t<Statement>, result_row_of_t<Statement>>;
+      if constexpr (constexpr auto _check = check_statement_preparable<base_connection>(type_v<Statement>); _check)
+      {
+        detail::thread_init();
+        const auto sql_string = to_sql_string_c(context_t{}, statement);
+        auto& cached = statements().get_or_prepare(sql_string, [this, &sql_string]() {
+          if constexpr (is_debug_allowed())
+            debug("Preparing: '" + sql_string + "'");
+          return detail::cached_statement_t{detail::prepare(_handle.get(), sql_string)};
+        });
+        if (cached.in_use)
+        {
+          return _prepared_statement_t{*this, statement};
+        }
+        mysql_stmt_free_result(cached.handle.get());
+        mysql_stmt_reset(cached.handle.get());
+        cached.in_use = true;
+        return _prepared_statement_t{*this, cached.handle.get(), &cached.in_use};
+      }
+      else
+      {
+        return ::sqlpp::bad_expression_t{_check};
+      }
+    }
+
+    // Statements prepared via prepare_cached() for the physical connection
+    auto statements() -> detail::statement_registry_t&
+    {
+      if constexpr (not std::is_same_v<Pool, ::sqlpp::no_pool>)
+      {
+        if (this->_pool_entry)
+          return this->_pool_entry->statements;
+      }
+      return _statements;
+    }
+
     auto start_transaction() -> void
     {
       if (_transaction_active)
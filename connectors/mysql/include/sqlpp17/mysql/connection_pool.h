@@ -26,116 +26,71 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <mutex>
+#include <cerrno>
+
+#include <poll.h>
+
+#include <sqlpp17/connection_pool.h>
 
 #include <sqlpp17/mysql/connection.h>
 
-namespace sqlpp::mysql::detail
+namespace sqlpp::mysql
 {
-  class circular_connection_buffer_t
+  // How the pool checks connections that have been idle for a while
+  enum class idle_check
   {
-    std::vector<detail::unique_connection_ptr> _data;
-    std::size_t _head = 0;
-    std::size_t _tail = 0;
-    std::size_t _size = 0;
-
-    auto increment(std::size_t& pos)
-    {
-      ++pos;
-      if (pos == _data.size())
-        pos = 0;
-    }
-
-  public:
-    circular_connection_buffer_t(std::size_t capacity) : _data(capacity)
-    {
-    }
-
-    [[nodiscard]] auto empty() const
-    {
-      return _size == 0;
-    }
-
-    [[nodiscard]] auto& front()
-    {
-      return _data[_tail];
-    }
-
-    auto pop_front() -> void
-    {
-      if ((_head != _tail) or not empty())
-      {
-        increment(_tail);
-        --_size;
-      }
-    }
-
-    auto push_back(detail::unique_connection_ptr t)
-    {
-      _data[_head] = std::move(t);
-      if ((_head != _tail) or empty())
-      {
-        increment(_head);
-        ++_size;
-      }
-      else  // (head == tail) and not empty()
-      {
-        increment(_head);
-        _tail = _head;
-      }
-    }
+    socket,  // local check: an idle connection has nothing to read, a readable socket means the server hung up
+    ping,    // mysql_ping(), a server round trip
   };
+}  // namespace sqlpp::mysql
+
+namespace sqlpp::mysql::detail
+{
+  inline auto socket_is_open(MYSQL* handle) -> bool
+  {
+    const auto socket = mysql_get_socket(handle);
+    if (socket < 0)
+      return false;
+    auto descriptor = pollfd{socket, POLLIN, 0};
+    const auto rc = poll(&descriptor, 1, 0);
+    return rc == 0 or (rc < 0 and errno == EINTR);
+  }
 }  // namespace sqlpp::mysql::detail
 
 namespace sqlpp::mysql
 {
-  template <::sqlpp::debug Debug>
-  class connection_pool_t
+  template <::sqlpp::debug Debug, idle_check Check = idle_check::socket>
+  struct connector_t
   {
-    connection_config_t _connection_config;
-    detail::circular_connection_buffer_t _handles;
-    std::mutex _mutex;
+    using config_type = connection_config_t;
+    using handle_type = detail::unique_connection_ptr;
+    using statement_registry_type = detail::statement_registry_t;
 
-    using _connection_t = ::sqlpp::mysql::base_connection<connection_pool_t, Debug>;
-    friend _connection_t;
+    template <typename Pool>
+    using connection_type = base_connection<Pool, Debug>;
 
-  public:
-    connection_pool_t() = delete;
-    connection_pool_t(std::size_t capacity, connection_config_t connection_config)
-        : _connection_config(std::move(connection_config)), _handles(capacity)
+    static auto connect(const config_type& config) -> handle_type
     {
+      return detail::connect(config);
     }
-    connection_pool_t(const connection_pool_t&) = delete;
-    connection_pool_t(connection_pool_t&&) = default;
-    connection_pool_t& operator=(const connection_pool_t&) = delete;
-    connection_pool_t& operator=(connection_pool_t&&) = default;
-    ~connection_pool_t() = default;
 
-    [[nodiscard]] __attribute__((no_sanitize("memory"))) auto get() -> _connection_t
+#if defined(__clang__)
+    __attribute__((no_sanitize("memory")))
+#endif
+    static auto is_alive(handle_type& handle) -> bool
     {
-      detail::thread_init();
-
-      const auto lock = std::scoped_lock{_mutex};
-
-      auto handle = detail::unique_connection_ptr(std::move(_handles.front()));
-      _handles.pop_front();
-
-      // destroy dead connections
-      if (handle and mysql_ping(handle.get()) != 0)
+      if constexpr (Check == idle_check::ping)
       {
-        handle.reset();
+        detail::thread_init();
+        return mysql_ping(handle.get()) == 0;
+      }
+      else
+      {
+        return detail::socket_is_open(handle.get());
       }
-
-      return handle ? _connection_t{_connection_config, std::move(handle), this}
-                    : _connection_t{_connection_config, this};
-    }
-
-  private:
-    auto put(detail::unique_connection_ptr handle) -> void
-    {
-      const auto lock = std::scoped_lock{_mutex};
-      _handles.push_back(std::move(handle));
     }
   };
 
+  template <::sqlpp::debug Debug, idle_check Check = idle_check::socket>
+  using connection_pool_t = ::sqlpp::connection_pool<connector_t<Debug, Check>>;
 }  // namespace sqlpp::mysql
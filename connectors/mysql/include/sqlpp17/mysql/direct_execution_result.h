@@ -137,6 +137,7 @@ namespace sqlpp ::mysql
     detail::unique_result_ptr _handle;
     MYSQL_ROW _data = nullptr;
     unsigned long* _lengths = nullptr;
+    std::size_t _remaining_rows = 0;
     result_row_t<ColumnSpecs...> _row;
 
   public:
@@ -146,6 +147,8 @@ namespace sqlpp ::mysql
     direct_execution_result_t(detail::unique_result_ptr handle)
         : _handle(std::move(handle))
     {
+      // Results are stored, see mysql_store_result()
+      _remaining_rows = _handle ? static_cast<std::size_t>(mysql_num_rows(_handle.get())) : 0;
     }
     direct_execution_result_t(const direct_execution_result_t&) = delete;
     direct_execution_result_t(direct_execution_result_t&& rhs) = default;
@@ -165,6 +168,7 @@ namespace sqlpp ::mysql
 
       if (_data != nullptr)
       {
+        --_remaining_rows;
         read_fields(_data, _lengths, _row);
       }
       else
@@ -178,6 +182,11 @@ namespace sqlpp ::mysql
       return _row;
     }
 
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      return _remaining_rows;
+    }
+
     auto* get() const
     {
       return _handle.get();
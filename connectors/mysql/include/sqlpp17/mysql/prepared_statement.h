@@ -44,17 +44,42 @@ namespace sqlpp::mysql::detail
 {
   struct prepared_statement_cleanup_t
   {
+    bool _owning = true;
+    // Set for statements borrowed from the statement registry, they are reset and handed back
+    bool* _in_use = nullptr;
+
   public:
     auto operator()(MYSQL_STMT* handle) const noexcept -> void
     {
-      if (handle)
+      if (_owning and handle)
       {
         mysql_stmt_close(handle);
       }
+      else if (_in_use and handle)
+      {
+        mysql_stmt_free_result(handle);
+        mysql_stmt_reset(handle);
+        *_in_use = false;
+      }
     }
   };
   using unique_prepared_statement_ptr = std::unique_ptr<MYSQL_STMT, detail::prepared_statement_cleanup_t>;
 
+  inline auto prepare(MYSQL* connection, const std::string& sql_string) -> unique_prepared_statement_ptr
+  {
+    auto handle = unique_prepared_statement_ptr(mysql_stmt_init(connection), {});
+    if (not handle)
+    {
+      throw sqlpp::exception("MySQL: Could not allocate prepared statement\n");
+    }
+    if (mysql_stmt_prepare(handle.get(), sql_string.data(), sql_string.size()))
+    {
+      throw sqlpp::exception("MySQL: Could not prepare statement: " + std::string(mysql_error(connection)) +
+                             " (statement was >>" + sql_string + "<<\n");
+    }
+    return handle;
+  }
+
 }  // namespace sqlpp::mysql::detail
 
 namespace sqlpp::mysql
@@ -203,16 +228,15 @@ namespace sqlpp::mysql
       if constexpr (Connection::is_debug_allowed())
         connection.debug("Preparing: '" + sql_string + "'");
 
-      _handle = detail::unique_prepared_statement_ptr(mysql_stmt_init(connection.get()), {});
-      if (not _handle)
-      {
-        throw sqlpp::exception("MySQL: Could not allocate prepared statement\n");
-      }
-      if (mysql_stmt_prepare(_handle.get(), sql_string.data(), sql_string.size()))
-      {
-        throw sqlpp::exception("MySQL: Could not prepare statement: " + std::string(mysql_error(connection.get())) +
-                               " (statement was >>" + sql_string + "<<\n");
-      }
+      _handle = detail::prepare(connection.get(), sql_string);
+    }
+
+    // Uses a statement owned by someone else, e.g. the connection's statement registry.
+    // in_use (if given) is cleared when this is destroyed.
+    template <typename Connection>
+    prepared_statement_t([[maybe_unused]] const Connection& connection, MYSQL_STMT* statement, bool* in_use = nullptr)
+        : _handle(statement, {false, in_use})
+    {
     }
     prepared_statement_t(const prepared_statement_t&) = delete;
     prepared_statement_t(prepared_statement_t&& rhs) = default;
@@ -317,6 +317,7 @@ namespace sqlpp::mysql
   {
     detail::unique_prepared_result_ptr _handle;
     bool _unbound = true;
+    std::size_t _remaining_rows = 0;
     std::tuple<buffer_type_of_t<ColumnSpecs>...> _bind_buffers; // For receiving optional values
     std::array<bind_meta_data_t, sizeof...(ColumnSpecs)> _bind_meta_data;  // For receiving is_null / length
     std::array<MYSQL_BIND, sizeof...(ColumnSpecs)> _bind_parameters;
@@ -330,6 +331,8 @@ namespace sqlpp::mysql
     prepared_statement_result_t(detail::unique_prepared_result_ptr&& handle, size_t number_of_columns)
         : _handle(std::move(handle))
     {
+      // Results are stored, see mysql_stmt_store_result()
+      _remaining_rows = _handle ? static_cast<std::size_t>(mysql_stmt_num_rows(_handle.get())) : 0;
     }
     prepared_statement_result_t(const prepared_statement_result_t&) = delete;
     prepared_statement_result_t(prepared_statement_result_t&& rhs) = default;
@@ -349,6 +352,7 @@ namespace sqlpp::mysql
 
       if (get_next_result_row(_handle.get(), _row, _bind_buffers, _bind_meta_data, _bind_parameters))
       {
+        --_remaining_rows;
         // assign bound fields, where necessary (e.g. optional columns, string_views)
         assign_fields(_row, _bind_buffers, _bind_meta_data, std::make_integer_sequence<unsigned, sizeof...(ColumnSpecs)>{});
       }
@@ -363,6 +367,11 @@ namespace sqlpp::mysql
       return _row;
     }
 
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      return _remaining_rows;
+    }
+
     [[nodiscard]] operator bool() const
     {
       return !!_handle;
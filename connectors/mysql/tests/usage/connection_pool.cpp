@@ -35,12 +35,14 @@ int main()
   try
   {
     mysql::global_library_init();
-    auto pool = mysql::connection_pool_t<::sqlpp::debug::none>{5, mysql::test::get_config()};
+    auto pool = mysql::connection_pool_t<::sqlpp::debug::none>{50, mysql::test::get_config()};
 
     ::sqlpp::test::test_basic_functionality(pool);
     ::sqlpp::test::test_single_connection(pool);
     ::sqlpp::test::test_multiple_connections(pool);
     ::sqlpp::test::test_multithreaded(pool);
+    ::sqlpp::test::test_bounded_capacity(pool);
+    ::sqlpp::test::test_fifo_waiters(pool);
 
   }
   catch (const std::exception& e)
@@ -0,0 +1,258 @@
+#pragma once
+
+/*
+Copyright (c) 2017 - 2018, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+
+#include <libpq-fe.h>
+
+#include <sqlpp17/exception.h>
+
+#include <sqlpp17/postgresql/connection.h>
+
+namespace sqlpp::postgresql
+{
+  enum class connect_wait
+  {
+    none,
+    read,
+    write,
+  };
+
+  // Establishes a connection without blocking, using PQconnectStart and PQconnectPoll.
+  // Call poll() whenever socket() is ready for wait() until it returns true, then take() the handle.
+  // Note that connect_timeout is not applied by libpq in this mode, see connect_many().
+  class connect_operation_t
+  {
+    std::function<void(PGconn*)> _post_connect;
+    detail::unique_connection_ptr _handle;
+    PostgresPollingStatusType _status = PGRES_POLLING_WRITING;
+
+    // Without a socket there is nothing to wait for, poll() would block forever
+    auto check_socket() const -> void
+    {
+      if (PQsocket(_handle.get()) < 0)
+      {
+        throw sqlpp::exception("Postgresql: could not connect to server: no socket: " +
+                               std::string(PQerrorMessage(_handle.get())));
+      }
+    }
+
+  public:
+    explicit connect_operation_t(const connection_config_t& config) : _post_connect(config.post_connect)
+    {
+      if (config.pre_connect)
+      {
+        config.pre_connect(nullptr);
+      }
+
+      _handle = detail::unique_connection_ptr{PQconnectStart(detail::make_conninfo(config).c_str())};
+      if (not _handle)
+      {
+        throw sqlpp::exception("Postgresql: out of memory while connecting to server");
+      }
+      if (PQstatus(_handle.get()) == CONNECTION_BAD)
+      {
+        throw sqlpp::exception("Postgresql: could not connect to server: " +
+                               std::string(PQerrorMessage(_handle.get())));
+      }
+      check_socket();
+    }
+
+    // The socket may change while connecting, e.g. when trying several hosts
+    [[nodiscard]] auto socket() const -> int
+    {
+      return PQsocket(_handle.get());
+    }
+
+    [[nodiscard]] auto wait() const -> connect_wait
+    {
+      switch (_status)
+      {
+        case PGRES_POLLING_READING:
+          return connect_wait::read;
+        case PGRES_POLLING_WRITING:
+          return connect_wait::write;
+        default:
+          return connect_wait::none;
+      }
+    }
+
+    // Advances the connection, returns true once it is established
+    auto poll() -> bool
+    {
+      _status = PQconnectPoll(_handle.get());
+      if (_status == PGRES_POLLING_FAILED)
+      {
+        throw sqlpp::exception("Postgresql: could not connect to server: " +
+                               std::string(PQerrorMessage(_handle.get())));
+      }
+      if (_status == PGRES_POLLING_OK)
+      {
+        return true;
+      }
+      check_socket();
+      return false;
+    }
+
+    [[nodiscard]] auto is_done() const -> bool
+    {
+      return _status == PGRES_POLLING_OK;
+    }
+
+    // Calls post_connect and hands over the established connection
+    [[nodiscard]] auto take() -> detail::unique_connection_ptr
+    {
+      if (not is_done())
+      {
+        throw sqlpp::exception("Postgresql: connection is not established yet");
+      }
+      if (_post_connect)
+      {
+        _post_connect(_handle.get());
+      }
+      return std::move(_handle);
+    }
+  };
+
+  // Opens count connections concurrently from the calling thread.
+  // Established connections are appended to handles, even if others fail. The first error is rethrown at the end.
+  // The timeout defaults to the config's connect_timeout (if any).
+  inline auto connect_many(const connection_config_t& config,
+                           std::size_t count,
+                           std::vector<detail::unique_connection_ptr>& handles,
+                           std::optional<std::chrono::milliseconds> timeout = std::nullopt) -> void
+  {
+    if (not timeout and config.connect_timeout and *config.connect_timeout > 0)
+    {
+      timeout = std::chrono::seconds{*config.connect_timeout};
+    }
+    const auto deadline = timeout ? std::optional{std::chrono::steady_clock::now() + *timeout} : std::nullopt;
+
+    auto first_error = std::exception_ptr{};
+    const auto fail = [&first_error](std::exception_ptr error) {
+      if (not first_error)
+        first_error = error;
+    };
+
+    auto operations = std::vector<std::optional<connect_operation_t>>{};
+    operations.reserve(count);
+    for (auto i = std::size_t{}; i < count; ++i)
+    {
+      try
+      {
+        operations.emplace_back(std::in_place, config);
+      }
+      catch (...)
+      {
+        fail(std::current_exception());
+      }
+    }
+
+    auto fds = std::vector<pollfd>{};
+    auto indexes = std::vector<std::size_t>{};
+    while (true)
+    {
+      fds.clear();
+      indexes.clear();
+      for (auto i = std::size_t{}; i < operations.size(); ++i)
+      {
+        if (not operations[i])
+          continue;
+        if (operations[i]->socket() < 0)
+        {
+          fail(std::make_exception_ptr(sqlpp::exception("Postgresql: could not connect to server: no socket")));
+          operations[i].reset();
+          continue;
+        }
+        const auto events = operations[i]->wait() == connect_wait::read ? POLLIN : POLLOUT;
+        fds.push_back(pollfd{operations[i]->socket(), static_cast<short>(events), 0});
+        indexes.push_back(i);
+      }
+      if (fds.empty())
+        break;
+
+      auto timeout_ms = -1;
+      if (deadline)
+      {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+        timeout_ms = static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0));
+      }
+
+      const auto rc = ::poll(fds.data(), fds.size(), timeout_ms);
+      if (rc < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        fail(std::make_exception_ptr(
+            sqlpp::exception("Postgresql: poll failed while connecting: " + std::string(std::strerror(errno)))));
+        break;
+      }
+      if (rc == 0)
+      {
+        fail(std::make_exception_ptr(sqlpp::exception("Postgresql: timeout while connecting to server")));
+        break;
+      }
+
+      for (auto k = std::size_t{}; k < fds.size(); ++k)
+      {
+        if (fds[k].revents == 0)
+          continue;
+        auto& operation = operations[indexes[k]];
+        try
+        {
+          if (operation->poll())
+          {
+            handles.push_back(operation->take());
+            operation.reset();
+          }
+        }
+        catch (...)
+        {
+          fail(std::current_exception());
+          operation.reset();
+        }
+      }
+    }
+
+    if (first_error)
+    {
+      std::rethrow_exception(first_error);
+    }
+  }
+}  // namespace sqlpp::postgresql
@@ -28,8 +28,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <functional>
 #include <memory>
+#include <algorithm>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <sqlpp17/result_row.h>
 
@@ -104,6 +109,45 @@ namespace sqlpp::postgresql
     (..., (read_field(result, row_index, static_cast<result_column_base<ColumnSpecs>&>(row)(), ++index)));
   }
 
+  inline auto read_field(PGresult* result, int row_index, std::string& value, int index) -> void
+  {
+    value.assign(PQgetvalue(result, row_index, index), PQgetlength(result, row_index, index));
+  }
+
+  inline auto read_field(PGresult* result, int row_index, std::optional<std::string>& value, int index) -> void
+  {
+    if (PQgetisnull(result, row_index, index))
+    {
+      value.reset();
+    }
+    else
+    {
+      value.emplace(PQgetvalue(result, row_index, index), PQgetlength(result, row_index, index));
+    }
+  }
+
+  template <typename... ColumnSpecs>
+  auto read_fields(PGresult* result, int row_index, owning_result_row_t<ColumnSpecs...>& row) -> void
+  {
+    int index = -1;
+    (..., (read_field(result, row_index, static_cast<owning_column_base<ColumnSpecs>&>(row)(), ++index)));
+  }
+
+  template <typename ColumnSpec, typename Target>
+  auto read_field_to(PGresult* result, int row_index, Target& target, int index) -> void
+  {
+    auto value = result_column_value_t<ColumnSpec>{};
+    read_field(result, row_index, value, index);
+    assign_to_member<ColumnSpec>(target, std::move(value));
+  }
+
+  template <typename... ColumnSpecs, typename Target>
+  auto read_fields_to(PGresult* result, int row_index, Target& target, type_vector<ColumnSpecs...>) -> void
+  {
+    int index = -1;
+    (..., read_field_to<ColumnSpecs>(result, row_index, target, ++index));
+  }
+
   template<typename ResultRow>
   class char_result_t
   {
@@ -115,7 +159,7 @@ namespace sqlpp::postgresql
   {
     detail::unique_result_ptr _handle;
     int _row_index = -1;
-    int _row_count;
+    int _row_count = 0;
 
     result_row_t<ColumnSpecs...> _row;
 
@@ -153,6 +197,79 @@ namespace sqlpp::postgresql
       return _row;
     }
 
+    // Bulk decoding for result_t::fetch(): all rows are already in the PGresult, so owning rows are filled
+    // directly from it, without going through the current row.
+    auto fetch_rows(std::vector<owning_result_row_t<ColumnSpecs...>>& rows, std::size_t n) -> void
+    {
+      const auto count = static_cast<int>(std::min(n, static_cast<std::size_t>(get_remaining_row_count())));
+      rows.resize(rows.size() + count);
+      decode_rows(rows.data() + (rows.size() - count), 0, count);
+      skip_rows(count);
+    }
+
+    // Decodes the next row into the members of target instead of the row, see result_t::as()
+    template <typename Target>
+    auto read_next_row_into(Target& target) -> bool
+    {
+      if (get_remaining_row_count() == 0)
+      {
+        reset();
+        return false;
+      }
+      ++_row_index;
+      read_fields_to(_handle.get(), _row_index, target, type_vector<ColumnSpecs...>{});
+      return true;
+    }
+
+    // Rows that have not been read via get_next_row() or fetch_rows() yet
+    [[nodiscard]] auto get_remaining_row_count() const -> int
+    {
+      return _handle ? _row_count - (_row_index + 1) : 0;
+    }
+
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      return static_cast<std::size_t>(get_remaining_row_count());
+    }
+
+    // Lengths are stored in the PGresult, no values are decoded
+    [[nodiscard]] auto byte_size_hint() const -> std::size_t
+    {
+      constexpr bool is_text[] = {
+          std::is_same_v<remove_optional_t<result_column_value_t<ColumnSpecs>>, std::string_view>...};
+      auto bytes = std::size_t{0};
+      for (int row = _row_index + 1; row < _row_count and _handle; ++row)
+      {
+        for (int column = 0; column < static_cast<int>(sizeof...(ColumnSpecs)); ++column)
+        {
+          if (is_text[column])
+          {
+            bytes += static_cast<std::size_t>(PQgetlength(_handle.get(), row, column));
+          }
+        }
+      }
+      return bytes;
+    }
+
+    // Decodes count rows, starting offset rows after the current one, into rows[0, count) without consuming them.
+    // The PGresult is read-only, so disjoint ranges can be decoded concurrently.
+    auto decode_rows(owning_result_row_t<ColumnSpecs...>* rows, int offset, int count) const -> void
+    {
+      const auto first = _row_index + 1 + offset;
+      for (int i = 0; i < count; ++i)
+      {
+        read_fields(_handle.get(), first + i, rows[i]);
+      }
+    }
+
+    auto skip_rows(int count) -> void
+    {
+      _row_index += count;
+      if (_row_index + 1 >= get_row_count())
+      {
+        reset();
+      }
+    }
 
     [[nodiscard]] operator bool() const
     {
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sqlpp17/connection.h>
 #include <sqlpp17/result.h>
 #include <sqlpp17/statement.h>
+#include <sqlpp17/statement_registry.h>
 
 #include <sqlpp17/postgresql/bool.h>
 #include <sqlpp17/postgresql/char_result.h>
@@ -68,6 +69,8 @@ namespace sqlpp::postgresql::detail
   };
   using unique_connection_ptr = std::unique_ptr<PGconn, detail::connection_cleanup_t>;
 
+  using statement_registry_t = ::sqlpp::statement_registry_t<unique_prepared_statement_ptr>;
+
   template<typename Connection, typename Statement>
   auto execute(const Connection& connection, const Statement& statement) -> detail::unique_result_ptr
   {
@@ -112,6 +115,62 @@ namespace sqlpp::postgresql::detail
     return value ? std::string(name) + "=" + std::to_string(*value) + " " : "";
   }
 
+  inline auto make_conninfo(const connection_config_t& config) -> std::string
+  {
+    auto conninfo = std::string{};
+    conninfo += detail::config_field_to_string("host", config.host);
+    conninfo += detail::config_field_to_string("hostaddr", config.hostaddr);
+    conninfo += detail::config_field_to_string("port", config.port);
+    conninfo += detail::config_field_to_string("dbname", config.dbname);
+    conninfo += detail::config_field_to_string("user", config.user);
+    conninfo += detail::config_field_to_string("password", config.password);
+    conninfo += detail::config_field_to_string("passfile", config.passfile);
+    conninfo += detail::config_field_to_string("connect_timeout", config.connect_timeout);
+    conninfo += detail::config_field_to_string("client_encoding", config.client_encoding);
+    conninfo += detail::config_field_to_string("options", config.options);
+    conninfo += detail::config_field_to_string("application_name", config.application_name);
+    conninfo += detail::config_field_to_string("fallback_application_name", config.fallback_application_name);
+    conninfo += detail::config_field_to_string("keepalives", config.keepalives);
+    conninfo += detail::config_field_to_string("keepalives_idle", config.keepalives_idle);
+    conninfo += detail::config_field_to_string("keepalives_interval", config.keepalives_interval);
+    conninfo += detail::config_field_to_string("keepalives_count", config.keepalives_count);
+    conninfo += detail::config_field_to_string("sslmode", config.sslmode);
+    conninfo += detail::config_field_to_string("sslcompression", config.sslcompression);
+    conninfo += detail::config_field_to_string("sslcert", config.sslcert);
+    conninfo += detail::config_field_to_string("sslkey", config.sslkey);
+    conninfo += detail::config_field_to_string("sslrootcert", config.sslrootcert);
+    conninfo += detail::config_field_to_string("sslcrl", config.sslcrl);
+    conninfo += detail::config_field_to_string("requirepeer", config.requirepeer);
+    conninfo += detail::config_field_to_string("krbsrvname", config.krbsrvname);
+    conninfo += detail::config_field_to_string("gsslib", config.gsslib);
+    conninfo += detail::config_field_to_string("service", config.service);
+    conninfo += detail::config_field_to_string("target_session_attrs", config.target_session_attrs);
+    return conninfo;
+  }
+
+  inline auto connect(const connection_config_t& config) -> unique_connection_ptr
+  {
+    if (config.pre_connect)
+    {
+      config.pre_connect(nullptr);
+    }
+
+    auto handle = unique_connection_ptr{PQconnectdb(make_conninfo(config).c_str())};
+
+    if (PQstatus(handle.get()) != CONNECTION_OK)
+    {
+      throw sqlpp::exception("Postgresql: could not connect to server: " +
+                             std::string(PQerrorMessage(handle.get())));
+    }
+
+    if (config.post_connect)
+    {
+      config.post_connect(handle.get());
+    }
+
+    return handle;
+  }
+
 }  // namespace sqlpp::postgresql::detail
 
 namespace sqlpp::postgresql
@@ -124,6 +183,8 @@ namespace sqlpp::postgresql
     using _pool_base = ::sqlpp::pool_base<Pool>;
     using _debug_base = ::sqlpp::debug_base<Debug>;
     detail::unique_connection_ptr _handle;
+    // used if this connection is not pooled, declared after the handle, so that statements are deallocated first
+    detail::statement_registry_t _statements;
     bool _transaction_active = false;
 
     mutable std::size_t _statement_index = 0;
@@ -143,61 +204,10 @@ namespace sqlpp::postgresql
     {
     }
 
-    base_connection(const connection_config_t& config, Pool* connection_pool) : base_connection{config}
-    {
-      this->_connection_pool = connection_pool;
-    }
-
   public:
     base_connection() = delete;
-    base_connection(const connection_config_t& config) : _debug_base{config.debug}, _handle{nullptr, {}}
+    base_connection(const connection_config_t& config) : _debug_base{config.debug}, _handle{detail::connect(config)}
     {
-      if (config.pre_connect)
-      {
-        config.pre_connect(get());
-      }
-
-      auto conninfo = std::string{};
-      conninfo += detail::config_field_to_string("host", config.host);
-      conninfo += detail::config_field_to_string("hostaddr", config.hostaddr);
-      conninfo += detail::config_field_to_string("port", config.port);
-      conninfo += detail::config_field_to_string("dbname", config.dbname);
-      conninfo += detail::config_field_to_string("user", config.user);
-      conninfo += detail::config_field_to_string("password", config.password);
-      conninfo += detail::config_field_to_string("passfile", config.passfile);
-      conninfo += detail::config_field_to_string("connect_timeout", config.connect_timeout);
-      conninfo += detail::config_field_to_string("client_encoding", config.client_encoding);
-      conninfo += detail::config_field_to_string("options", config.options);
-      conninfo += detail::config_field_to_string("application_name", config.application_name);
-      conninfo += detail::config_field_to_string("fallback_application_name", config.fallback_application_name);
-      conninfo += detail::config_field_to_string("keepalives", config.keepalives);
-      conninfo += detail::config_field_to_string("keepalives_idle", config.keepalives_idle);
-      conninfo += detail::config_field_to_string("keepalives_interval", config.keepalives_interval);
-      conninfo += detail::config_field_to_string("keepalives_count", config.keepalives_count);
-      conninfo += detail::config_field_to_string("sslmode", config.sslmode);
-      conninfo += detail::config_field_to_string("sslcompression", config.sslcompression);
-      conninfo += detail::config_field_to_string("sslcert", config.sslcert);
-      conninfo += detail::config_field_to_string("sslkey", config.sslkey);
-      conninfo += detail::config_field_to_string("sslrootcert", config.sslrootcert);
-      conninfo += detail::config_field_to_string("sslcrl", config.sslcrl);
-      conninfo += detail::config_field_to_string("requirepeer", config.requirepeer);
-      conninfo += detail::config_field_to_string("krbsrvname", config.krbsrvname);
-      conninfo += detail::config_field_to_string("gsslib", config.gsslib);
-      conninfo += detail::config_field_to_string("service", config.service);
-      conninfo += detail::config_field_to_string("target_session_attrs", config.target_session_attrs);
-
-      _handle.reset(PQconnectdb(conninfo.c_str()));
-
-      if (PQstatus(_handle.get()) != CONNECTION_OK)
-      {
-        throw sqlpp::exception("Postgresql: could not connect to server: " +
-                               std::string(PQerrorMessage(_handle.get())));
-      }
-
-      if (config.post_connect)
-      {
-        config.post_connect(_handle.get());
-      }
     }
     base_connection(const base_connection&) = delete;
     base_connection(base_connection&&) = default;
@@ -207,8 +217,8 @@ namespace sqlpp::postgresql
     {
       if constexpr (not std::is_same_v<Pool, ::sqlpp::no_pool>)
       {
-        if (this->_connection_pool)
-          this->_connection_pool->put(std::move(_handle));
+        if (this->_connection_pool and _handle)
+          this->_connection_pool->put(std::move(_handle), this->_pool_entry);
       }
     }
 
@@ -267,6 +277,45 @@ namespace sqlpp::postgresql
       }
     }
 
+    // Like prepare(), but the statement is kept in statements() and reused for the same SQL, also by later users of
+    // the same pooled connection
+    template <typename... Clauses>
+    auto prepare_cached(const ::sqlpp::statement<Clauses...>& statement)
+    {
+      using Statement = ::sqlpp::statement<Clauses...>;
+      if constexpr (constexpr auto _check = check_statement_preparable<base_connection>(type_v<Statement>); _check)
+      {
+        using _prepared_statement_t =
+            prepared_statement_t<result_type_of_t<Statement>, parameters_of_t<Statement>, result_row_of_t<Statement>>;
+        const auto sql_string = to_sql_string_c(context_t{}, statement);
+        auto& registry = statements();
+        auto& handle = registry.get_or_prepare(sql_string, [this, &registry, &sql_string]() {
+          // the registry lives as long as the physical connection, its counter keeps names unique
+          auto name = "sqlpp_cached_" + std::to_string(registry.misses());
+          if constexpr (is_debug_allowed())
+            debug("Preparing " + name + ": '" + sql_string + "'");
+          detail::prepare(_handle.get(), name, sql_string, parameters_of_t<Statement>::size());
+          return unique_prepared_statement_ptr(_handle.get(), {std::move(name)});
+        });
+        return _prepared_statement_t{*this, handle};
+      }
+      else
+      {
+        return ::sqlpp::bad_expression_t{_check};
+      }
+    }
+
+    // Statements prepared via prepare_cached() for the physical connection
+    auto statements() -> detail::statement_registry_t&
+    {
+      if constexpr (not std::is_same_v<Pool, ::sqlpp::no_pool>)
+      {
+        if (this->_pool_entry)
+          return this->_pool_entry->statements;
+      }
+      return _statements;
+    }
+
     auto start_transaction() -> void
     {
       if (_transaction_active)
@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+Copyright (c) 2017 - 2018, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_row.h>
+
+#include <sqlpp17/postgresql/char_result.h>
+
+namespace sqlpp::postgresql
+{
+  struct parallel_fetch_config_t
+  {
+    // 0: std::thread::hardware_concurrency()
+    std::size_t thread_count = 0;
+    // Smaller ranges are not worth a thread
+    std::size_t min_rows_per_thread = 10000;
+  };
+
+  // Decodes all remaining rows of a buffered result into owning rows. The row range is split into contiguous
+  // ranges which are decoded by separate threads into a pre-sized vector, the calling thread takes the first one.
+  template <typename ResultRow>
+  [[nodiscard]] auto parallel_fetch_all(::sqlpp::result_t<char_result_t<ResultRow>>& result,
+                                        const parallel_fetch_config_t& config = {})
+      -> std::vector<owning_row_t<ResultRow>>
+  {
+    auto& handle = result._handle;
+    const auto count = static_cast<std::size_t>(handle.get_remaining_row_count());
+    auto rows = std::vector<owning_row_t<ResultRow>>(count);
+
+    const auto max_threads = config.thread_count ? config.thread_count
+                                                 : std::max(std::size_t{1}, std::size_t{std::thread::hardware_concurrency()});
+    const auto range_count =
+        std::clamp(count / std::max(std::size_t{1}, config.min_rows_per_thread), std::size_t{1}, max_threads);
+    const auto range_size = (count + range_count - 1) / range_count;
+
+    const auto decode = [&handle, &rows, count, range_size](std::size_t range) {
+      const auto first = std::min(count, range * range_size);
+      const auto last = std::min(count, first + range_size);
+      handle.decode_rows(rows.data() + first, static_cast<int>(first), static_cast<int>(last - first));
+    };
+
+    auto futures = std::vector<std::future<void>>{};
+    auto first_error = std::exception_ptr{};
+    try
+    {
+      for (std::size_t range = 1; range < range_count; ++range)
+      {
+        futures.push_back(std::async(std::launch::async, decode, range));
+      }
+      decode(0);
+    }
+    catch (...)
+    {
+      first_error = std::current_exception();
+    }
+    // All threads write into rows, wait for each of them before leaving
+    for (auto& future : futures)
+    {
+      try
+      {
+        future.get();
+      }
+      catch (...)
+      {
+        if (not first_error)
+        {
+          first_error = std::current_exception();
+        }
+      }
+    }
+    if (first_error)
+    {
+      std::rethrow_exception(first_error);
+    }
+
+    handle.skip_rows(static_cast<int>(count));
+    return rows;
+  }
+}  // namespace sqlpp::postgresql
@@ -41,16 +41,47 @@ namespace sqlpp::postgresql
   struct prepared_statement_cleanup_t
   {
     std::string _name;
+    bool _owning = true;
   public:
     auto operator()(PGconn* handle) const noexcept -> void
     {
-      if (handle)
+      if (_owning and handle)
       {
         PQexec(handle, ("DEALLOCATE " + _name).c_str());
       }
     }
   };
   using unique_prepared_statement_ptr = std::unique_ptr<PGconn, prepared_statement_cleanup_t>;
+}  // namespace sqlpp::postgresql
+
+namespace sqlpp::postgresql::detail
+{
+  inline auto prepare(PGconn* connection, const std::string& name, const std::string& sql_string, int parameter_count)
+      -> void
+  {
+    auto result =
+        detail::unique_result_ptr(PQprepare(connection, name.c_str(), sql_string.c_str(), parameter_count, nullptr), {});
+
+    if (not result)
+    {
+      throw sqlpp::exception("Postgresql: out of memory (query was >>" + sql_string + "<<\n");
+    }
+
+    switch (PQresultStatus(result.get()))
+    {
+      case PGRES_COMMAND_OK:
+        [[fallthrough]];
+      case PGRES_TUPLES_OK:
+        break;
+      default:
+        throw sqlpp::exception(std::string("Postgresql: Error during query preparation: ") +
+                               PQresultErrorMessage(result.get()) + " (query was >>" + sql_string + "<<\n");
+    }
+  }
+}  // namespace sqlpp::postgresql::detail
+
+namespace sqlpp::postgresql
+{
 
   inline auto bind_parameter([[maybe_unused]] std::string& parameter_string, char*& parameter_pointer, const std::nullopt_t& value) -> void
   {
@@ -146,24 +177,14 @@ namespace sqlpp::postgresql
       if constexpr (Connection::is_debug_allowed())
         connection.debug("Preparing " + _name + ": '" + sql_string + "'");
 
-      auto result = detail::unique_result_ptr(
-          PQprepare(connection.get(), _name.c_str(), sql_string.c_str(), ParameterVector::size(), nullptr), {});
-
-      if (not result)
-      {
-        throw sqlpp::exception("Postgresql: out of memory (query was >>" + sql_string + "<<\n");
-      }
+      detail::prepare(connection.get(), _name, sql_string, ParameterVector::size());
+    }
 
-      switch (PQresultStatus(result.get()))
-      {
-        case PGRES_COMMAND_OK:
-          [[fallthrough]];
-        case PGRES_TUPLES_OK:
-          break;
-        default:
-          throw sqlpp::exception(std::string("Postgresql: Error during query preparation: ") +
-                                 PQresultErrorMessage(result.get()) + " (query was >>" + sql_string + "<<\n");
-      }
+    // Uses a statement owned by someone else, e.g. the connection's statement registry
+    template <typename Connection>
+    prepared_statement_t([[maybe_unused]] const Connection& connection, const unique_prepared_statement_ptr& statement)
+        : _name(statement.get_deleter()._name), _connection(statement.get(), {_name, false})
+    {
     }
     prepared_statement_t(const prepared_statement_t&) = delete;
     prepared_statement_t(prepared_statement_t&& rhs) = default;
@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2017 - 2018, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sqlpp17/postgresql/async_connect.h>
+#include <sqlpp17/postgresql/connection_pool.h>
+
+#include <sqlpp17_test/expect.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  // Nobody listens on port 1, connection attempts fail fast
+  auto unreachable_config()
+  {
+    auto config = ::sqlpp::postgresql::connection_config_t{};
+    config.hostaddr = "127.0.0.1";
+    config.port = "1";
+    config.dbname = "sqlpp17_test";
+    return config;
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    static_assert(::sqlpp::detail::has_connect_many_v<::sqlpp::postgresql::connector_t<::sqlpp::debug::none>>);
+
+    // A single operation, driven manually
+    {
+      auto operation = ::sqlpp::postgresql::connect_operation_t{unreachable_config()};
+      expect(operation.socket() >= 0, "expected a socket");
+      auto failed = false;
+      try
+      {
+        while (not operation.poll())
+        {
+        }
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed, "expected the connection to fail");
+    }
+
+    // Several connections from one thread
+    {
+      auto handles = std::vector<::sqlpp::postgresql::detail::unique_connection_ptr>{};
+      const auto start = std::chrono::steady_clock::now();
+      try
+      {
+        ::sqlpp::postgresql::connect_many(unreachable_config(), 8, handles, std::chrono::seconds{5});
+        throw std::logic_error("expected connect_many to fail");
+      }
+      catch (const ::sqlpp::exception& e)
+      {
+        expect(std::string_view(e.what()).find("could not connect to server") != std::string_view::npos,
+               "expected a connection failure");
+      }
+      expect(handles.empty(), "expected no connections");
+      expect(std::chrono::steady_clock::now() - start < std::chrono::seconds{5}, "expected failures before the timeout");
+    }
+
+    // Pools use connect_many for prewarming
+    {
+      auto failed = false;
+      try
+      {
+        auto pool = ::sqlpp::postgresql::connection_pool_t<::sqlpp::debug::none>{
+            ::sqlpp::connection_pool_config_t{4, 4}, unreachable_config()};
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed, "expected pool construction to fail");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
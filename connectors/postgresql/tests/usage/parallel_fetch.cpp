@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2017 - 2018, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <chrono>
+
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/postgresql/parallel_fetch.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  using row_t = ::sqlpp::result_row_of_t<decltype(
+      ::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name, ::test::tabDepartment.division)
+          .from(::test::tabDepartment)
+          .where(::test::tabDepartment.id > 0))>;
+  using result_t = ::sqlpp::result_t<::sqlpp::postgresql::char_result_t<row_t>>;
+
+  // Buffered results are built without a server, PGresults are filled via PQsetvalue
+  auto make_result(int row_count) -> result_t
+  {
+    auto handle = ::sqlpp::postgresql::detail::unique_result_ptr{PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK)};
+    char id[] = "id";
+    char name[] = "name";
+    char division[] = "division";
+    PGresAttDesc attributes[] = {{id, 0, 0, 0, 20, 8, -1}, {name, 0, 0, 0, 25, -1, -1}, {division, 0, 0, 0, 25, -1, -1}};
+    expect(PQsetResultAttrs(handle.get(), 3, attributes), "could not set result attributes");
+    for (int row = 0; row < row_count; ++row)
+    {
+      auto id_text = std::to_string(row + 1);
+      auto name_text = "name_" + id_text;
+      auto division_text = std::string(row % 2 ? "sales" : "engineering");
+      expect(PQsetvalue(handle.get(), row, 0, id_text.data(), static_cast<int>(id_text.size())) and
+                 PQsetvalue(handle.get(), row, 1, row % 7 ? name_text.data() : nullptr,
+                            row % 7 ? static_cast<int>(name_text.size()) : -1) and
+                 PQsetvalue(handle.get(), row, 2, division_text.data(), static_cast<int>(division_text.size())),
+             "could not set value");
+    }
+    return result_t{::sqlpp::postgresql::char_result_t<row_t>{std::move(handle)}};
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    constexpr auto row_count = 50000;
+    const auto expected = make_result(row_count).fetch_all();
+    expect(expected.size() == row_count, "unexpected sequential row count");
+    expect(expected[1].id == 2 and expected[1].name == std::string("name_2") and not expected[7].name and
+               expected[1].division == "sales",
+           "unexpected sequential rows");
+
+    for (const auto thread_count : {1u, 3u, 8u})
+    {
+      auto result = make_result(row_count);
+      auto config = ::sqlpp::postgresql::parallel_fetch_config_t{};
+      config.thread_count = thread_count;
+      config.min_rows_per_thread = 1000;
+      const auto rows = ::sqlpp::postgresql::parallel_fetch_all(result, config);
+      expect(rows.size() == row_count, "unexpected parallel row count");
+      for (std::size_t i = 0; i < rows.size(); ++i)
+      {
+        expect(rows[i].id == expected[i].id and rows[i].name == expected[i].name and
+                   rows[i].division == expected[i].division,
+               "parallel and sequential rows differ");
+      }
+      expect(not result._handle, "expected the result to be exhausted");
+    }
+
+    // Only the remaining rows are decoded
+    {
+      auto result = make_result(100);
+      expect(result.size_hint() == std::optional<std::size_t>{100}, "expected all rows in the size hint");
+      auto first = result.fetch(10);
+      auto text_bytes = std::size_t{0};
+      for (int i = 10; i < 100; ++i)
+      {
+        text_bytes += (i % 7 ? expected[i].name->size() : 0) + expected[i].division.size();
+      }
+      expect(result.size_hint() == std::optional<std::size_t>{90}, "expected the remaining rows in the size hint");
+      expect(result.byte_size_hint() == std::optional<std::size_t>{text_bytes}, "unexpected byte size hint");
+      const auto rest = ::sqlpp::postgresql::parallel_fetch_all(result);
+      expect(rest.size() == 90 and rest.front().id == 11 and rest.back().id == 100, "unexpected remaining rows");
+      expect(::sqlpp::postgresql::parallel_fetch_all(result).empty(), "expected no more rows");
+      expect(result.size_hint() == std::optional<std::size_t>{0}, "expected no more rows in the size hint");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
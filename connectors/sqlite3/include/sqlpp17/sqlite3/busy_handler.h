@@ -0,0 +1,225 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <thread>
+
+#ifdef SQLPP_USE_SQLCIPHER
+#include <sqlcipher/sqlite3.h>
+#else
+#include <sqlite3.h>
+#endif
+
+#include <sqlpp17/sqlite3/interrupt_handler.h>
+
+namespace sqlpp::sqlite3
+{
+  // Governs how long a connection keeps retrying when the database is locked by another connection.
+  // Each wait is drawn from [(1 - jitter) * delay, delay], with delay growing exponentially, so that
+  // competing connections do not retry in lock step.
+  // The policy is installed via sqlite3_busy_handler(), which replaces any sqlite3_busy_timeout() (or
+  // PRAGMA busy_timeout) set on the connection, and vice versa.
+  struct busy_retry_policy_t
+  {
+    std::chrono::microseconds initial_delay = std::chrono::milliseconds{1};
+    std::chrono::microseconds max_delay = std::chrono::milliseconds{100};
+    double multiplier = 2.0;
+    double jitter = 0.5;
+    // Total time waited for a single lock before giving up with SQLITE_BUSY. Waiting also stops at the
+    // connection's deadline or the statement timeout.
+    std::chrono::microseconds max_wait = std::chrono::seconds{5};
+  };
+
+  struct busy_statistics_t
+  {
+    std::atomic<std::uint64_t> busy_events = 0;  // times a lock was found busy, counting each lock once
+    std::atomic<std::uint64_t> retries = 0;
+    std::atomic<std::uint64_t> give_ups = 0;  // times the max_wait was exceeded
+    std::atomic<std::uint64_t> microseconds_waited = 0;
+
+    [[nodiscard]] auto time_waited() const
+    {
+      return std::chrono::microseconds{microseconds_waited.load()};
+    }
+  };
+}  // namespace sqlpp::sqlite3
+
+namespace sqlpp::sqlite3::detail
+{
+  class busy_handler_t
+  {
+    std::optional<busy_retry_policy_t> _policy;
+    std::shared_ptr<busy_statistics_t> _statistics;
+    // Waiting for a lock stops at its deadline, if any
+    const interrupt_handler_t* _interrupt_handler;
+    std::chrono::steady_clock::time_point _first_busy;
+    std::chrono::microseconds _waited = {};
+    int _attempts = 0;
+    // Set once the current step() has waited for a lock
+    bool _waiting = false;
+    // Set while step() retries a statement, sqlite3 then restarts its count for the same lock
+    bool _retrying = false;
+    bool _exhausted = false;
+
+    auto start_waiting() -> void
+    {
+      _first_busy = std::chrono::steady_clock::now();
+      _waited = {};
+      _attempts = 0;
+      _waiting = true;
+      ++_statistics->busy_events;
+    }
+
+    auto sleep() -> bool
+    {
+      if (not _policy)
+        return false;
+
+      const auto& policy = *_policy;
+      auto delay = static_cast<double>(policy.initial_delay.count());
+      for (auto i = 0; i < _attempts and delay < policy.max_delay.count(); ++i)
+        delay *= policy.multiplier;
+      delay = std::min(delay, static_cast<double>(policy.max_delay.count()));
+      delay *= 1.0 - std::clamp(policy.jitter, 0.0, 1.0) * random_fraction();
+
+      auto duration = std::chrono::microseconds{static_cast<std::int64_t>(delay)};
+      if (_waited + duration > policy.max_wait)
+      {
+        ++_statistics->give_ups;
+        _exhausted = true;
+        return false;
+      }
+      if (_interrupt_handler)
+      {
+        const auto deadline = _interrupt_handler->deadline();
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+        {
+          _exhausted = true;
+          return false;
+        }
+        duration = std::min(duration, std::chrono::ceil<std::chrono::microseconds>(deadline - now));
+      }
+
+      std::this_thread::sleep_for(duration);
+      const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _first_busy);
+      _statistics->microseconds_waited += static_cast<std::uint64_t>((waited - _waited).count());
+      _waited = waited;
+      ++_attempts;
+      ++_statistics->retries;
+      return true;
+    }
+
+    static auto random_fraction() -> double
+    {
+      thread_local auto engine = std::minstd_rand{std::random_device{}()};
+      return std::uniform_real_distribution<double>{0.0, 1.0}(engine);
+    }
+
+    static auto on_busy(void* self, int count) -> int
+    {
+      return static_cast<busy_handler_t*>(self)->wait(count);
+    }
+
+  public:
+    busy_handler_t(std::optional<busy_retry_policy_t> policy,
+                   std::shared_ptr<busy_statistics_t> statistics,
+                   const interrupt_handler_t* interrupt_handler = nullptr)
+        : _policy(std::move(policy)),
+          _statistics(statistics ? std::move(statistics) : std::make_shared<busy_statistics_t>()),
+          _interrupt_handler(interrupt_handler)
+    {
+    }
+
+    [[nodiscard]] auto enabled() const
+    {
+      return _policy.has_value();
+    }
+
+    [[nodiscard]] auto exhausted() const
+    {
+      return _exhausted;
+    }
+
+    // Called by step() before and after stepping a statement
+    auto begin_step() -> void
+    {
+      _exhausted = false;
+      _waiting = false;
+      _retrying = false;
+    }
+
+    auto end_step() -> void
+    {
+      _retrying = false;
+    }
+
+    [[nodiscard]] auto& statistics() const
+    {
+      return *_statistics;
+    }
+
+    auto install(::sqlite3* connection) -> void
+    {
+      if (enabled())
+        sqlite3_busy_handler(connection, &on_busy, this);
+    }
+
+    auto uninstall(::sqlite3* connection) -> void
+    {
+      if (enabled() and connection)
+        sqlite3_busy_handler(connection, nullptr, nullptr);
+    }
+
+    // Called by sqlite3, returns true after sleeping, if another attempt should be made; attempt is 0 for the first
+    // retry of a lock
+    auto wait(int attempt) -> bool
+    {
+      if (attempt == 0 and not _retrying)
+        start_waiting();
+      return sleep();
+    }
+
+    // Called by step() when sqlite3 returned SQLITE_BUSY, continues counting attempts and time of the same lock
+    auto retry() -> bool
+    {
+      if (not enabled())
+        return false;
+      if (not _waiting)
+        start_waiting();
+      _retrying = true;
+      return sleep();
+    }
+  };
+}  // namespace sqlpp::sqlite3::detail
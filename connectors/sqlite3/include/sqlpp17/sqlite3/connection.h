@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sqlpp17/exception.h>
 #include <sqlpp17/result.h>
 #include <sqlpp17/statement.h>
+#include <sqlpp17/statement_registry.h>
 #include <sqlpp17/clause/command.h>
 
 #include <sqlpp17/sqlite3/clause.h>
@@ -42,6 +43,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sqlpp17/sqlite3/parameter.h>
 #include <sqlpp17/sqlite3/prepared_statement.h>
 #include <sqlpp17/sqlite3/prepared_statement_result.h>
+#include <sqlpp17/sqlite3/snapshot.h>
 
 namespace sqlpp::sqlite3
 {
@@ -67,6 +69,65 @@ namespace sqlpp::sqlite3::detail
   };
   using unique_connection_ptr = std::unique_ptr<::sqlite3, detail::connection_cleanup_t>;
 
+  inline auto connect(const connection_config_t& config) -> unique_connection_ptr
+  {
+    ::sqlite3* connection_ptr = nullptr;
+    const auto rc = sqlite3_open_v2(config.path_to_database.c_str(), &connection_ptr, config.flags,
+                                    config.vfs.empty() ? nullptr : config.vfs.c_str());
+    auto handle = unique_connection_ptr{connection_ptr};
+
+    if (rc != SQLITE_OK)
+    {
+      throw sqlpp::exception("Sqlite3: Can't open database: " + std::string(sqlite3_errmsg(connection_ptr)));
+    }
+
+#ifdef SQLITE_HAS_CODEC
+    if (config.password.size() > 0)
+    {
+      const auto ret = sqlite3_key(connection_ptr, config.password.data(), config.password.size());
+      if (ret != SQLITE_OK)
+      {
+        throw sqlpp::exception("Sqlite3: Can't set password for database: " +
+                               std::string(sqlite3_errmsg(connection_ptr)));
+      }
+    }
+#endif
+
+    if (config.post_connect)
+    {
+      config.post_connect(connection_ptr);
+    }
+
+    return handle;
+  }
+
+  // A statement of prepare_cached(), used by one prepared statement at a time
+  struct cached_statement_t
+  {
+    unique_prepared_statement_ptr handle;
+    bool in_use = false;
+  };
+
+  using statement_registry_t = ::sqlpp::statement_registry_t<cached_statement_t>;
+
+  inline auto make_connection_state(const connection_config_t& config) -> std::unique_ptr<connection_state_t>
+  {
+    return std::make_unique<connection_state_t>(config.busy_retry, config.busy_statistics, config.statement_timeout,
+                                                config.progress_handler_steps);
+  }
+
+  inline auto open_snapshot_file(const std::string& path, int flags) -> unique_connection_ptr
+  {
+    ::sqlite3* connection_ptr = nullptr;
+    const auto rc = sqlite3_open_v2(path.c_str(), &connection_ptr, flags, nullptr);
+    auto handle = unique_connection_ptr{connection_ptr};
+    if (rc != SQLITE_OK)
+    {
+      throw sqlpp::exception("Sqlite3: Can't open database " + path + ": " + std::string(sqlite3_errmsg(connection_ptr)));
+    }
+    return handle;
+  }
+
 }  // namespace sqlpp::sqlite3::detail
 
 namespace sqlpp::sqlite3
@@ -79,7 +140,11 @@ namespace sqlpp::sqlite3
     using _pool_base = ::sqlpp::pool_base<Pool>;
     using _debug_base = ::sqlpp::debug_base<Debug>;
 
+    // declared before the handle, so that the handle is closed first
+    std::unique_ptr<detail::connection_state_t> _state;
     detail::unique_connection_ptr _handle;
+    // used if this connection is not pooled, declared after the handle, so that statements are finalized first
+    detail::statement_registry_t _statements;
     bool _transaction_active = false;
 
     template <typename... Clauses>
@@ -93,46 +158,22 @@ namespace sqlpp::sqlite3
     base_connection(const connection_config_t& config,
                  detail::unique_connection_ptr&& handle,
                  Pool* connection_pool)
-        : _pool_base{connection_pool}, _debug_base{config.debug}, _handle{std::move(handle)}
-    {
-    }
-
-    base_connection(const connection_config_t& config, Pool* connection_pool) : base_connection{config}
+        : _pool_base{connection_pool},
+          _debug_base{config.debug},
+          _state{detail::make_connection_state(config)},
+          _handle{std::move(handle)}
     {
-      this->_connection_pool = connection_pool;
+      _state->install(_handle.get());
     }
 
   public:
     base_connection() = delete;
-    base_connection(const connection_config_t& config) : _debug_base{config.debug}, _handle{nullptr, {}}
+    base_connection(const connection_config_t& config)
+        : _debug_base{config.debug},
+          _state{detail::make_connection_state(config)},
+          _handle{detail::connect(config)}
     {
-      ::sqlite3* connection_ptr = nullptr;
-      const auto rc = sqlite3_open_v2(config.path_to_database.c_str(), &connection_ptr, config.flags,
-                                      config.vfs.empty() ? nullptr : config.vfs.c_str());
-      _handle.reset(connection_ptr);
-
-      if (rc != SQLITE_OK)
-      {
-        throw sqlpp::exception("Sqlite3: Can't open database: " + std::string(sqlite3_errmsg(connection_ptr)));
-      }
-
-#ifdef SQLITE_HAS_CODEC
-      if (config.password.size() > 0)
-      {
-        const auto ret = sqlite3_key(sqlite, config.password.data(), config.password.size());
-        if (ret != SQLITE_OK)
-        {
-          const std::string msg = sqlite3_errmsg(sqlite);
-          throw sqlpp::exception("Sqlite3: Can't set password for database: " +
-                                 std::string(sqlite3_errmsg(connection_ptr)));
-        }
-      }
-#endif
-
-      if (config.post_connect)
-      {
-        config.post_connect(_handle.get());
-      }
+      _state->install(_handle.get());
     }
 
     base_connection(const base_connection&) = delete;
@@ -143,8 +184,14 @@ namespace sqlpp::sqlite3
     {
       if constexpr (not std::is_same_v<Pool, ::sqlpp::no_pool>)
       {
-        if (this->_connection_pool)
-          this->_connection_pool->put(std::move(_handle));
+        if (this->_connection_pool and _handle)
+        {
+          // the callbacks refer to this connection's state
+          _state->uninstall(_handle.get());
+          // idle connections must not keep read transactions open via unfinished cached statements
+          statements().for_each([](detail::cached_statement_t& cached) { sqlite3_reset(cached.handle.get()); });
+          this->_connection_pool->put(std::move(_handle), this->_pool_entry);
+        }
       }
     }
 
@@ -206,6 +253,48 @@ namespace sqlpp::sqlite3
       }
     }
 
+    // Like prepare(), but the native statement is kept in statements() and reused for the same SQL, also by later
+    // users of the same pooled connection. It is reset when handed out and when the prepared statement is destroyed.
+    // While it is in use, further prepared statements for the same SQL get a statement of their own.
+    template <typename... Clauses>
+    auto prepare_cached(const ::sqlpp::statement<Clauses...>& statement)
+    {
+      using Statement = ::sqlpp::statement<Clauses...>;
+      using _prepared_statement_t =
+          prepared_statement_t<result_type_of_t<Statement>, parameters_of_t<Statement>, result_row_of_t<Statement>>;
+      if constexpr (constexpr auto _check = check_statement_preparable<base_connection>(type_v<Statement>); _check)
+      {
+        const auto sql_string = to_sql_string_c(context_t{}, statement);
+        auto& cached = statements().get_or_prepare(sql_string, [this, &sql_string]() {
+          return detail::cached_statement_t{detail::prepare(_handle.get(), sql_string)};
+        });
+        if (cached.in_use)
+        {
+          return _prepared_statement_t{*this, sql_string, detail::result_owns_statement{false}};
+        }
+        // The return value repeats the error of a failed step of an earlier user, if any
+        sqlite3_reset(cached.handle.get());
+        sqlite3_clear_bindings(cached.handle.get());
+        cached.in_use = true;
+        return _prepared_statement_t{*this, cached.handle.get(), &cached.in_use};
+      }
+      else
+      {
+        return ::sqlpp::bad_expression_t{_check};
+      }
+    }
+
+    // Statements prepared via prepare_cached() for the physical connection
+    auto statements() -> detail::statement_registry_t&
+    {
+      if constexpr (not std::is_same_v<Pool, ::sqlpp::no_pool>)
+      {
+        if (this->_pool_entry)
+          return this->_pool_entry->statements;
+      }
+      return _statements;
+    }
+
     auto start_transaction() -> void
     {
       if (_transaction_active)
@@ -280,6 +369,73 @@ namespace sqlpp::sqlite3
 
     auto is_alive() -> bool;
 
+    auto* state() const
+    {
+      return _state.get();
+    }
+
+    // Interrupts the statement currently executed by this connection with cancelled_exception.
+    // If no statement is running, e.g. because the cancel() raced with the statement's start or end, the next
+    // statement started on this connection throws cancelled_exception instead, whatever it is.
+    // May be called from any thread while the connection is alive.
+    auto cancel() -> void
+    {
+      _state->interrupt_handler.cancel();
+      sqlite3_interrupt(_handle.get());
+    }
+
+    // Interrupts statements with deadline_exceeded_exception once the deadline has passed, until cleared.
+    // Checked every progress_handler_steps virtual machine steps.
+    auto set_deadline(std::chrono::steady_clock::time_point deadline) -> void
+    {
+      _state->interrupt_handler.set_deadline(deadline);
+      _state->interrupt_handler.install(_handle.get());
+    }
+
+    auto clear_deadline() -> void
+    {
+      _state->interrupt_handler.clear_deadline(_handle.get());
+    }
+
+    // Page cache and memory counters of this connection
+    [[nodiscard]] auto status() const -> database_status_t
+    {
+      return detail::database_status(_handle.get(), false);
+    }
+
+    // Resets the counters of status(), returns their values before the reset
+    auto reset_status() -> database_status_t
+    {
+      return detail::database_status(_handle.get(), true);
+    }
+
+    [[nodiscard]] auto busy_statistics() const -> const busy_statistics_t&
+    {
+      return _state->busy_handler.statistics();
+    }
+
+    // Replaces the contents of this connection's database with the database file at path, e.g. to populate an
+    // in-memory database. Uses the online backup API, i.e. the file may be in use by other connections.
+    auto load_from_file(const std::string& path, const backup_options_t& options = {}) -> void
+    {
+      auto source = detail::open_snapshot_file(path, SQLITE_OPEN_READONLY);
+      detail::backup(_handle.get(), source.get(), options);
+    }
+
+    // Writes a snapshot of this connection's database to the file at path, replacing its previous contents
+    auto save_to_file(const std::string& path, const backup_options_t& options = {}) -> void
+    {
+      auto destination = detail::open_snapshot_file(path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+      detail::backup(destination.get(), _handle.get(), options);
+    }
+
+    // Replaces this connection's database with an in-memory copy of the database file at path.
+    // Faster than load_from_file, but the file must not be written to while it is being read.
+    auto deserialize_file(const std::string& path, const deserialize_options_t& options = {}) -> void
+    {
+      detail::deserialize_file(_handle.get(), path, options);
+    }
+
   private:
     template <typename... Clauses>
     auto execute(const ::sqlpp::statement<Clauses...>& statement)
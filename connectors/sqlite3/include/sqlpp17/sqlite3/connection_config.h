@@ -32,6 +32,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sqlite3.h>
 #endif
 
+#include <sqlpp17/sqlite3/busy_handler.h>
+#include <sqlpp17/sqlite3/interrupt_handler.h>
+
 namespace sqlpp::sqlite3
 {
   struct connection_config_t
@@ -42,6 +45,14 @@ namespace sqlpp::sqlite3
     int flags = 0;
     std::string vfs;
     std::function<void(std::string_view)> debug;
+    // Without a policy, SQLITE_BUSY is reported immediately
+    std::optional<busy_retry_policy_t> busy_retry;
+    // Optional, e.g. to share statistics among all connections of a pool
+    std::shared_ptr<busy_statistics_t> busy_statistics;
+    // Each statement execution is interrupted with deadline_exceeded_exception after this time
+    std::optional<std::chrono::milliseconds> statement_timeout;
+    // Number of virtual machine steps between deadline checks
+    int progress_handler_steps = 1000;
 
     connection_config_t() = default;
     connection_config_t(const connection_config_t&) = default;
@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+#ifdef SQLPP_USE_SQLCIPHER
+#include <sqlcipher/sqlite3.h>
+#else
+#include <sqlite3.h>
+#endif
+
+#include <sqlpp17/exception.h>
+
+#include <sqlpp17/sqlite3/busy_handler.h>
+#include <sqlpp17/sqlite3/interrupt_handler.h>
+
+namespace sqlpp::sqlite3::detail
+{
+  // State registered with sqlite3 callbacks, shared by a connection with its statements and results.
+  // Heap allocated, so that it does not move with the connection.
+  struct connection_state_t
+  {
+    interrupt_handler_t interrupt_handler;
+    busy_handler_t busy_handler;
+
+    connection_state_t(std::optional<busy_retry_policy_t> busy_retry,
+                       std::shared_ptr<busy_statistics_t> busy_statistics,
+                       std::optional<std::chrono::milliseconds> statement_timeout,
+                       int progress_handler_steps)
+        : interrupt_handler{statement_timeout, progress_handler_steps},
+          busy_handler{std::move(busy_retry), std::move(busy_statistics), &interrupt_handler}
+    {
+    }
+
+    auto install(::sqlite3* connection) -> void
+    {
+      busy_handler.install(connection);
+      if (interrupt_handler.has_statement_timeout())
+        interrupt_handler.install(connection);
+    }
+
+    auto uninstall(::sqlite3* connection) -> void
+    {
+      busy_handler.uninstall(connection);
+      interrupt_handler.uninstall(connection);
+    }
+  };
+
+  // sqlite3 does not call the busy handler in all situations, e.g. when waiting might deadlock. Outside of explicit
+  // transactions, the statement can simply be stepped again (unless the busy handler has already given up).
+  inline auto step(::sqlite3_stmt* statement, connection_state_t* state) -> int
+  {
+    if (not state)
+      return sqlite3_step(statement);
+
+    auto& busy_handler = state->busy_handler;
+    busy_handler.begin_step();
+
+    auto rc = sqlite3_step(statement);
+    while (rc == SQLITE_BUSY and not busy_handler.exhausted() and
+           sqlite3_get_autocommit(sqlite3_db_handle(statement)) and busy_handler.retry())
+    {
+      rc = sqlite3_step(statement);
+    }
+    busy_handler.end_step();
+    return rc;
+  }
+
+  // The statement has finished
+  inline auto finish_statement(connection_state_t* state) -> void
+  {
+    if (state)
+      state->interrupt_handler.finish_statement();
+  }
+
+  [[noreturn]] inline auto throw_step_error(int rc, connection_state_t* state, const std::string& message) -> void
+  {
+    if (rc == SQLITE_INTERRUPT and state)
+      state->interrupt_handler.throw_interrupted();
+    finish_statement(state);
+    throw sqlpp::exception(message + std::string(sqlite3_errstr(rc)));
+  }
+}  // namespace sqlpp::sqlite3::detail
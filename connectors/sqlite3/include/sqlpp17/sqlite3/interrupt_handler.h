@@ -0,0 +1,179 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+#ifdef SQLPP_USE_SQLCIPHER
+#include <sqlcipher/sqlite3.h>
+#else
+#include <sqlite3.h>
+#endif
+
+#include <sqlpp17/exception.h>
+
+namespace sqlpp::sqlite3
+{
+  // Thrown if a statement was aborted by sqlite3_interrupt() or the progress handler
+  class interrupted_exception : public ::sqlpp::exception
+  {
+    using exception::exception;
+  };
+
+  // Thrown if the statement exceeded its deadline
+  class deadline_exceeded_exception : public interrupted_exception
+  {
+    using interrupted_exception::interrupted_exception;
+  };
+
+  // Thrown if the statement was cancelled, see base_connection::cancel()
+  class cancelled_exception : public interrupted_exception
+  {
+    using interrupted_exception::interrupted_exception;
+  };
+}  // namespace sqlpp::sqlite3
+
+namespace sqlpp::sqlite3::detail
+{
+  class interrupt_handler_t
+  {
+    using clock = std::chrono::steady_clock;
+
+    std::optional<std::chrono::milliseconds> _statement_timeout;
+    int _steps;
+    bool _installed = false;
+    clock::time_point _deadline = clock::time_point::max();
+    clock::time_point _statement_deadline = clock::time_point::max();
+    bool _deadline_exceeded = false;
+    std::atomic<bool> _cancelled = false;
+
+    static auto on_progress(void* self) -> int
+    {
+      auto& handler = *static_cast<interrupt_handler_t*>(self);
+      if (handler._cancelled)
+      {
+        return 1;
+      }
+      if (clock::now() >= std::min(handler._deadline, handler._statement_deadline))
+      {
+        handler._deadline_exceeded = true;
+        return 1;
+      }
+      return 0;
+    }
+
+  public:
+    interrupt_handler_t(std::optional<std::chrono::milliseconds> statement_timeout, int steps)
+        : _statement_timeout(statement_timeout), _steps(steps > 0 ? steps : 1)
+    {
+    }
+
+    auto install(::sqlite3* connection) -> void
+    {
+      if (not _installed and connection)
+      {
+        sqlite3_progress_handler(connection, _steps, &on_progress, this);
+        _installed = true;
+      }
+    }
+
+    auto uninstall(::sqlite3* connection) -> void
+    {
+      if (_installed and connection)
+      {
+        sqlite3_progress_handler(connection, 0, nullptr, nullptr);
+        _installed = false;
+      }
+    }
+
+    [[nodiscard]] auto has_statement_timeout() const
+    {
+      return _statement_timeout.has_value();
+    }
+
+    auto set_deadline(clock::time_point deadline) -> void
+    {
+      _deadline = deadline;
+    }
+
+    // The progress handler is only kept while there is a deadline or statement timeout
+    auto clear_deadline(::sqlite3* connection) -> void
+    {
+      _deadline = clock::time_point::max();
+      if (not _statement_timeout)
+        uninstall(connection);
+    }
+
+    // The earlier of the deadline and the per-statement deadline
+    [[nodiscard]] auto deadline() const -> clock::time_point
+    {
+      return std::min(_deadline, _statement_deadline);
+    }
+
+    // Called from any thread, sqlite3_interrupt() is called by the connection. Stays pending until a statement
+    // finishes or is started, see start_statement().
+    auto cancel() -> void
+    {
+      _cancelled = true;
+    }
+
+    // Arms the per-statement timeout. A cancel() since the last statement finished cancels this one.
+    auto start_statement() -> void
+    {
+      _deadline_exceeded = false;
+      if (_cancelled)
+      {
+        finish_statement();
+        throw cancelled_exception("Sqlite3: Statement was cancelled");
+      }
+      if (_statement_timeout)
+        _statement_deadline = clock::now() + *_statement_timeout;
+    }
+
+    // Disarms the per-statement timeout and forgets a cancel()
+    auto finish_statement() -> void
+    {
+      _statement_deadline = clock::time_point::max();
+      _cancelled = false;
+    }
+
+    [[noreturn]] auto throw_interrupted() -> void
+    {
+      const auto deadline_exceeded = _deadline_exceeded;
+      const bool cancelled = _cancelled;
+      finish_statement();
+      if (deadline_exceeded)
+        throw deadline_exceeded_exception("Sqlite3: Statement exceeded its deadline");
+      if (cancelled)
+        throw cancelled_exception("Sqlite3: Statement was cancelled");
+      throw interrupted_exception("Sqlite3: Statement was interrupted");
+    }
+  };
+}  // namespace sqlpp::sqlite3::detail
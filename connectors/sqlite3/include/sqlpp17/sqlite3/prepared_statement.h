@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 
 #ifdef SQLPP_USE_SQLCIPHER
@@ -40,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sqlpp17/prepared_statement_parameters.h>
 
 #include <sqlpp17/sqlite3/prepared_statement_result.h>
+#include <sqlpp17/sqlite3/status.h>
 
 namespace sqlpp::sqlite3::detail
 {
@@ -58,6 +60,23 @@ namespace sqlpp::sqlite3::detail
                                " bind returned unexpected value: " + std::to_string(result));
     }
   }
+
+  inline auto prepare(::sqlite3* connection, const std::string& sql_string) -> unique_prepared_statement_ptr
+  {
+    ::sqlite3_stmt* statement_ptr = nullptr;
+
+    const auto rc = sqlite3_prepare_v2(connection, sql_string.c_str(), static_cast<int>(sql_string.size()),
+                                       &statement_ptr, nullptr);
+
+    auto handle = unique_prepared_statement_ptr(statement_ptr, {true});
+
+    if (rc != SQLITE_OK)
+    {
+      throw sqlpp::exception("Sqlite3: Could not prepare statement: " + std::string(sqlite3_errmsg(connection)) +
+                             " (statement was >>" + sql_string + "<<)\n");
+    }
+    return handle;
+  }
 }  // namespace sqlpp::sqlite3::detail
 
 namespace sqlpp::sqlite3
@@ -132,28 +151,33 @@ namespace sqlpp::sqlite3
     detail::unique_prepared_statement_ptr _handle;
     detail::result_owns_statement _ownership;
     ::sqlite3* _connection;
+    detail::connection_state_t* _state;
 
   public:
+    using result_type = ResultType;
+
     ::sqlpp::prepared_statement_parameters<ParameterVector> parameters = {};
 
     prepared_statement_t() = default;
 
     template <typename Connection>
     prepared_statement_t(const Connection& connection, const std::string& sql_string, detail::result_owns_statement ownership)
-        : _ownership(ownership), _connection(connection.get())
+        : _handle(detail::prepare(connection.get(), sql_string)),
+          _ownership(ownership),
+          _connection(connection.get()),
+          _state(connection.state())
     {
-      ::sqlite3_stmt* statement_ptr = nullptr;
-
-      const auto rc = sqlite3_prepare_v2(connection.get(), sql_string.c_str(), static_cast<int>(sql_string.size()),
-                                         &statement_ptr, nullptr);
-
-      _handle = detail::unique_prepared_statement_ptr(statement_ptr, {true});
+    }
 
-      if (rc != SQLITE_OK)
-      {
-        throw sqlpp::exception("Sqlite3: Could not prepare statement: " + std::string(sqlite3_errmsg(connection.get())) +
-                               " (statement was >>" + sql_string + "<<)\n");
-      }
+    // Uses a statement owned by someone else, e.g. the connection's statement registry.
+    // in_use (if given) is cleared when this is destroyed.
+    template <typename Connection>
+    prepared_statement_t(const Connection& connection, ::sqlite3_stmt* statement, bool* in_use = nullptr)
+        : _handle(statement, {false, in_use}),
+          _ownership(detail::result_owns_statement{false}),
+          _connection(connection.get()),
+          _state(connection.state())
+    {
     }
 
     template <typename Connection, typename Statement>
@@ -176,18 +200,22 @@ namespace sqlpp::sqlite3
 
       ::sqlpp::sqlite3::bind_parameters(_handle.get(), parameters);
 
+      if (_state)
+        _state->interrupt_handler.start_statement();
+
       if constexpr (not std::is_same_v<ResultType, select_result>)
       {
-        switch (const auto rc = sqlite3_step(_handle.get()); rc)
+        switch (const auto rc = detail::step(_handle.get(), _state); rc)
         {
           case SQLITE_OK:
             [[fallthrough]];
           case SQLITE_ROW:
             [[fallthrough]];  // might occur if execute is called with a select
           case SQLITE_DONE:
+            detail::finish_statement(_state);
             break;
           default:
-            throw sqlpp::exception("Sqlite3: Could not execute statement: "  + std::string(sqlite3_errstr(rc)));
+            detail::throw_step_error(rc, _state, "Sqlite3: Could not execute statement: ");
         }
       }
 
@@ -205,10 +233,11 @@ namespace sqlpp::sqlite3
       }
       else if constexpr (std::is_same_v<ResultType, select_result>)
       {
-        return ::sqlpp::result_t<prepared_statement_result_t<ResultRow>>{
+        return ::sqlpp::result_t<prepared_statement_result_t<ResultRow>>{prepared_statement_result_t<ResultRow>{
             (_ownership == (detail::result_owns_statement{true}))
                 ? detail::unique_prepared_statement_ptr{_handle.release(), {true}}
-                : detail::unique_prepared_statement_ptr{_handle.get(), {false}}};
+                : detail::unique_prepared_statement_ptr{_handle.get(), {false}},
+            _state}};
       }
       else if constexpr (std::is_same_v<ResultType, execute_result>)
       {
@@ -229,6 +258,18 @@ namespace sqlpp::sqlite3
     {
       return _connection;
     }
+
+    // Counters accumulated over all executions of this statement
+    [[nodiscard]] auto status() const -> statement_status_t
+    {
+      return detail::statement_status(_handle.get(), false);
+    }
+
+    // Resets the counters of status(), returns their values before the reset
+    auto reset_status() -> statement_status_t
+    {
+      return detail::statement_status(_handle.get(), true);
+    }
   };
 
   template <typename Connection, typename Statement>
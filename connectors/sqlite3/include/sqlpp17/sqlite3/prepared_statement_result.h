@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <optional>
 #include <string_view>
+#include <utility>
 
 #ifdef SQLPP_USE_SQLCIPHER
 #include <sqlcipher/sqlite3.h>
@@ -39,6 +40,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <sqlpp17/result_row.h>
 
+#include <sqlpp17/sqlite3/connection_state.h>
+
 namespace sqlpp::sqlite3::detail
 {
   enum class result_owns_statement : bool {};
@@ -46,6 +49,8 @@ namespace sqlpp::sqlite3::detail
   struct prepared_statement_cleanup_t
   {
     bool _owning;
+    // Set for statements borrowed from the statement registry, they are reset and handed back
+    bool* _in_use = nullptr;
 
     auto operator()(::sqlite3_stmt* handle) const noexcept -> void
     {
@@ -53,23 +58,29 @@ namespace sqlpp::sqlite3::detail
       {
         sqlite3_finalize(handle);
       }
+      else if (_in_use and handle)
+      {
+        sqlite3_reset(handle);
+        sqlite3_clear_bindings(handle);
+        *_in_use = false;
+      }
     }
   };
   using unique_prepared_statement_ptr = std::unique_ptr<::sqlite3_stmt, detail::prepared_statement_cleanup_t>;
 
-  inline auto get_next_result_row(::sqlite3_stmt* stmt) -> bool
+  inline auto get_next_result_row(::sqlite3_stmt* stmt, connection_state_t* state) -> bool
   {
-    auto rc = sqlite3_step(stmt);
+    auto rc = detail::step(stmt, state);
 
     switch (rc)
     {
       case SQLITE_ROW:
         return true;
       case SQLITE_DONE:
+        finish_statement(state);
         return false;
       default:
-        throw sqlpp::exception("Sqlite3 error: Unexpected return value for sqlite3_step(): " +
-                               std::string(sqlite3_errstr(rc)));
+        throw_step_error(rc, state, "Sqlite3 error: Unexpected return value for sqlite3_step(): ");
     }
   }
 }  // namespace sqlpp::sqlite3::detail
@@ -129,6 +140,23 @@ namespace sqlpp::sqlite3
     (..., assign_field(stmt, static_cast<result_column_base<ColumnSpecs>&>(row)(), Is));
   }
 
+  template <typename ColumnSpec, typename Target>
+  auto assign_field_to(sqlite3_stmt* stmt, Target& target, int index) -> void
+  {
+    auto value = result_column_value_t<ColumnSpec>{};
+    assign_field(stmt, value, index);
+    assign_to_member<ColumnSpec>(target, std::move(value));
+  }
+
+  template <typename... ColumnSpecs, typename Target, unsigned... Is>
+  auto assign_fields_to(sqlite3_stmt* stmt,
+                        Target& target,
+                        type_vector<ColumnSpecs...>,
+                        std::integer_sequence<unsigned, Is...>) -> void
+  {
+    (..., assign_field_to<ColumnSpecs>(stmt, target, Is));
+  }
+
   template <typename ResultRow>
   class prepared_statement_result_t
   {
@@ -139,6 +167,7 @@ namespace sqlpp::sqlite3
   class prepared_statement_result_t<result_row_t<ColumnSpecs...>>
   {
     detail::unique_prepared_statement_ptr _handle;
+    detail::connection_state_t* _state = nullptr;
 
     result_row_t<ColumnSpecs...> _row;
 
@@ -146,8 +175,8 @@ namespace sqlpp::sqlite3
     using row_type = decltype(_row);
 
     prepared_statement_result_t() = default;
-    prepared_statement_result_t(detail::unique_prepared_statement_ptr&& handle)
-        : _handle(std::move(handle))
+    prepared_statement_result_t(detail::unique_prepared_statement_ptr&& handle, detail::connection_state_t* state)
+        : _handle(std::move(handle)), _state(state)
     {
     }
     prepared_statement_result_t(const prepared_statement_result_t&) = delete;
@@ -158,7 +187,7 @@ namespace sqlpp::sqlite3
 
     auto get_next_row() -> void
     {
-      if (detail::get_next_result_row(_handle.get()))
+      if (detail::get_next_result_row(_handle.get(), _state))
       {
         assign_fields(_handle.get(), _row, std::make_integer_sequence<unsigned, sizeof...(ColumnSpecs)>{});
       }
@@ -168,6 +197,20 @@ namespace sqlpp::sqlite3
       }
     }
 
+    // Decodes the next row into the members of target instead of the row, see result_t::as()
+    template <typename Target>
+    auto read_next_row_into(Target& target) -> bool
+    {
+      if (not detail::get_next_result_row(_handle.get(), _state))
+      {
+        reset();
+        return false;
+      }
+      assign_fields_to(_handle.get(), target, type_vector<ColumnSpecs...>{},
+                       std::make_integer_sequence<unsigned, sizeof...(ColumnSpecs)>{});
+      return true;
+    }
+
     [[nodiscard]] auto& row() const
     {
       return _row;
@@ -185,6 +228,8 @@ namespace sqlpp::sqlite3
 
     auto reset() -> void
     {
+      if (_handle)
+        detail::finish_statement(_state);
       *this = {};
     }
   };
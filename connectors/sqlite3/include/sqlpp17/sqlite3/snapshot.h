@@ -0,0 +1,195 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#ifdef SQLPP_USE_SQLCIPHER
+#include <sqlcipher/sqlite3.h>
+#else
+#include <sqlite3.h>
+#endif
+
+#include <sqlpp17/exception.h>
+
+namespace sqlpp::sqlite3
+{
+  // Online backup via sqlite3_backup_step()
+  struct backup_options_t
+  {
+    // -1 copies all pages in one step. Smaller steps release the source's read lock in between.
+    int pages_per_step = -1;
+    std::chrono::milliseconds sleep_between_steps = std::chrono::milliseconds{0};
+    // While the source or destination is locked, steps are retried with a delay that doubles up to max_busy_delay.
+    // The backup fails once a lock has been waited for longer than busy_timeout.
+    std::chrono::milliseconds busy_delay = std::chrono::milliseconds{1};
+    std::chrono::milliseconds max_busy_delay = std::chrono::milliseconds{100};
+    std::chrono::milliseconds busy_timeout = std::chrono::seconds{5};
+    // Called after each successful step with the number of pages copied so far and the total number of pages
+    std::function<void(int, int)> progress;
+    std::string schema = "main";
+  };
+
+  // Loading a database file into memory via sqlite3_deserialize()
+  struct deserialize_options_t
+  {
+    // The in-memory database cannot be modified or grow if true
+    bool read_only = false;
+    std::size_t bytes_per_step = 16 * 1024 * 1024;
+    // Called after each step with the number of bytes read so far and the total number of bytes
+    std::function<void(std::size_t, std::size_t)> progress;
+    std::string schema = "main";
+  };
+}  // namespace sqlpp::sqlite3
+
+namespace sqlpp::sqlite3::detail
+{
+  struct backup_cleanup_t
+  {
+    auto operator()(::sqlite3_backup* handle) const noexcept -> void
+    {
+      if (handle)
+      {
+        sqlite3_backup_finish(handle);
+      }
+    }
+  };
+  using unique_backup_ptr = std::unique_ptr<::sqlite3_backup, backup_cleanup_t>;
+
+  inline auto backup(::sqlite3* destination, ::sqlite3* source, const backup_options_t& options) -> void
+  {
+    auto handle = unique_backup_ptr{
+        sqlite3_backup_init(destination, options.schema.c_str(), source, options.schema.c_str())};
+    if (not handle)
+    {
+      throw sqlpp::exception("Sqlite3: Could not start backup: " + std::string(sqlite3_errmsg(destination)));
+    }
+
+    const auto report_progress = [&options, &handle]() {
+      if (options.progress)
+      {
+        const auto page_count = sqlite3_backup_pagecount(handle.get());
+        options.progress(page_count - sqlite3_backup_remaining(handle.get()), page_count);
+      }
+    };
+
+    auto busy_since = std::optional<std::chrono::steady_clock::time_point>{};
+    auto busy_delay = std::max(options.busy_delay, std::chrono::milliseconds{1});
+    while (true)
+    {
+      switch (const auto rc = sqlite3_backup_step(handle.get(), options.pages_per_step); rc)
+      {
+        case SQLITE_DONE:
+          report_progress();
+          return;
+        case SQLITE_OK:
+          report_progress();
+          busy_since.reset();
+          busy_delay = std::max(options.busy_delay, std::chrono::milliseconds{1});
+          if (options.sleep_between_steps.count())
+            std::this_thread::sleep_for(options.sleep_between_steps);
+          break;
+        case SQLITE_BUSY:
+          [[fallthrough]];
+        case SQLITE_LOCKED:
+        {
+          const auto now = std::chrono::steady_clock::now();
+          if (not busy_since)
+            busy_since = now;
+          if (now - *busy_since + busy_delay > options.busy_timeout)
+          {
+            throw sqlpp::exception("Sqlite3: Backup gave up waiting for a lock: " + std::string(sqlite3_errstr(rc)));
+          }
+          std::this_thread::sleep_for(busy_delay);
+          busy_delay = std::min(busy_delay * 2, std::max(options.max_busy_delay, busy_delay));
+          break;
+        }
+        default:
+          throw sqlpp::exception("Sqlite3: Backup failed: " + std::string(sqlite3_errstr(rc)));
+      }
+    }
+  }
+
+  inline auto deserialize_file(::sqlite3* destination, const std::string& path, const deserialize_options_t& options)
+      -> void
+  {
+#ifdef SQLITE_OMIT_DESERIALIZE
+    throw sqlpp::exception("Sqlite3: sqlite3_deserialize() is not available in this build of sqlite3");
+#else
+    // Read straight into the buffer that sqlite3 takes over
+    auto file = std::ifstream{path, std::ios::binary | std::ios::ate};
+    if (not file)
+    {
+      throw sqlpp::exception("Sqlite3: Could not open " + path);
+    }
+    const auto end = static_cast<std::streamoff>(file.tellg());
+    if (end < 0 or not file.seekg(0))
+    {
+      throw sqlpp::exception("Sqlite3: Could not determine the size of " + path);
+    }
+    const auto size = static_cast<std::size_t>(end);
+
+    auto buffer = std::unique_ptr<unsigned char, decltype(&sqlite3_free)>{
+        static_cast<unsigned char*>(sqlite3_malloc64(std::max<sqlite3_uint64>(size, 1))), &sqlite3_free};
+    if (not buffer)
+    {
+      throw sqlpp::exception("Sqlite3: Could not allocate " + std::to_string(size) + " bytes for " + path);
+    }
+
+    const auto step = std::max<std::size_t>(options.bytes_per_step, 1);
+    for (auto offset = std::size_t{}; offset < size;)
+    {
+      const auto chunk = std::min(step, size - offset);
+      if (not file.read(reinterpret_cast<char*>(buffer.get() + offset), static_cast<std::streamsize>(chunk)))
+      {
+        throw sqlpp::exception("Sqlite3: Could not read " + path);
+      }
+      offset += chunk;
+      if (options.progress)
+        options.progress(offset, size);
+    }
+
+    auto flags = SQLITE_DESERIALIZE_FREEONCLOSE;
+    flags |= options.read_only ? SQLITE_DESERIALIZE_READONLY : SQLITE_DESERIALIZE_RESIZEABLE;
+
+    // sqlite3 takes ownership of the buffer, even if this fails
+    const auto rc = sqlite3_deserialize(destination, options.schema.c_str(), buffer.release(),
+                                        static_cast<sqlite3_int64>(size), static_cast<sqlite3_int64>(size), flags);
+    if (rc != SQLITE_OK)
+    {
+      throw sqlpp::exception("Sqlite3: Could not deserialize " + path + ": " + std::string(sqlite3_errstr(rc)));
+    }
+#endif
+  }
+}  // namespace sqlpp::sqlite3::detail
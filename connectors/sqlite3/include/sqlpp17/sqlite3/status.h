@@ -0,0 +1,197 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <map>
+#include <ostream>
+#include <string_view>
+
+#ifdef SQLPP_USE_SQLCIPHER
+#include <sqlcipher/sqlite3.h>
+#else
+#include <sqlite3.h>
+#endif
+
+#include <sqlpp17/exception.h>
+#include <sqlpp17/type_traits.h>
+
+namespace sqlpp::sqlite3
+{
+  // See sqlite3_stmt_status()
+  struct statement_status_t
+  {
+    int fullscan_steps = 0;  // steps in full table scans, high values suggest a missing index
+    int sorts = 0;
+    int autoindexes = 0;  // rows inserted into automatic indexes, also suggests a missing index
+    int vm_steps = 0;
+    int reprepares = 0;
+    int runs = 0;
+    int memory_used = 0;
+
+    auto operator+=(const statement_status_t& rhs) -> statement_status_t&
+    {
+      fullscan_steps += rhs.fullscan_steps;
+      sorts += rhs.sorts;
+      autoindexes += rhs.autoindexes;
+      vm_steps += rhs.vm_steps;
+      reprepares += rhs.reprepares;
+      runs += rhs.runs;
+      memory_used += rhs.memory_used;
+      return *this;
+    }
+  };
+
+  struct status_value_t
+  {
+    int current = 0;
+    int highwater = 0;
+  };
+
+  // See sqlite3_db_status()
+  struct database_status_t
+  {
+    int cache_hits = 0;
+    int cache_misses = 0;
+    int cache_writes = 0;
+    int cache_spills = 0;
+    int cache_used = 0;  // bytes
+    status_value_t lookaside_used;  // slots
+    int lookaside_hits = 0;
+    int lookaside_misses_size = 0;
+    int lookaside_misses_full = 0;
+    int schema_used = 0;  // bytes
+    int statements_used = 0;  // bytes
+  };
+}  // namespace sqlpp::sqlite3
+
+namespace sqlpp::sqlite3::detail
+{
+  inline auto statement_status(::sqlite3_stmt* statement, bool reset) -> statement_status_t
+  {
+    const auto get = [statement, reset](int op) { return sqlite3_stmt_status(statement, op, reset); };
+    auto status = statement_status_t{};
+    status.fullscan_steps = get(SQLITE_STMTSTATUS_FULLSCAN_STEP);
+    status.sorts = get(SQLITE_STMTSTATUS_SORT);
+    status.autoindexes = get(SQLITE_STMTSTATUS_AUTOINDEX);
+    status.vm_steps = get(SQLITE_STMTSTATUS_VM_STEP);
+    status.reprepares = get(SQLITE_STMTSTATUS_REPREPARE);
+    status.runs = get(SQLITE_STMTSTATUS_RUN);
+    status.memory_used = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_MEMUSED, false);
+    return status;
+  }
+
+  inline auto database_status(::sqlite3* connection, bool reset) -> database_status_t
+  {
+    const auto get = [connection, reset](int op) {
+      auto value = status_value_t{};
+      if (const auto rc = sqlite3_db_status(connection, op, &value.current, &value.highwater, reset); rc != SQLITE_OK)
+      {
+        throw sqlpp::exception("Sqlite3: Could not read database status: " + std::string(sqlite3_errstr(rc)));
+      }
+      return value;
+    };
+    auto status = database_status_t{};
+    status.cache_hits = get(SQLITE_DBSTATUS_CACHE_HIT).current;
+    status.cache_misses = get(SQLITE_DBSTATUS_CACHE_MISS).current;
+    status.cache_writes = get(SQLITE_DBSTATUS_CACHE_WRITE).current;
+    status.cache_spills = get(SQLITE_DBSTATUS_CACHE_SPILL).current;
+    status.cache_used = get(SQLITE_DBSTATUS_CACHE_USED).current;
+    status.lookaside_used = get(SQLITE_DBSTATUS_LOOKASIDE_USED);
+    // for these, the value is reported as highwater
+    status.lookaside_hits = get(SQLITE_DBSTATUS_LOOKASIDE_HIT).highwater;
+    status.lookaside_misses_size = get(SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE).highwater;
+    status.lookaside_misses_full = get(SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL).highwater;
+    status.schema_used = get(SQLITE_DBSTATUS_SCHEMA_USED).current;
+    status.statements_used = get(SQLITE_DBSTATUS_STMT_USED).current;
+    return status;
+  }
+}  // namespace sqlpp::sqlite3::detail
+
+namespace sqlpp::sqlite3
+{
+  template <typename ResultType>
+  constexpr auto statement_type_name() -> std::string_view
+  {
+    if constexpr (std::is_same_v<ResultType, ::sqlpp::select_result>)
+      return "select";
+    else if constexpr (std::is_same_v<ResultType, ::sqlpp::insert_result>)
+      return "insert";
+    else if constexpr (std::is_same_v<ResultType, ::sqlpp::update_result>)
+      return "update";
+    else if constexpr (std::is_same_v<ResultType, ::sqlpp::delete_result>)
+      return "delete";
+    else
+      return "execute";
+  }
+
+  inline auto operator<<(std::ostream& os, const statement_status_t& status) -> std::ostream&
+  {
+    return os << "fullscan_steps=" << status.fullscan_steps << " sorts=" << status.sorts
+              << " autoindexes=" << status.autoindexes << " vm_steps=" << status.vm_steps
+              << " reprepares=" << status.reprepares << " runs=" << status.runs
+              << " memory_used=" << status.memory_used;
+  }
+
+  inline auto operator<<(std::ostream& os, const database_status_t& status) -> std::ostream&
+  {
+    return os << "cache_hits=" << status.cache_hits << " cache_misses=" << status.cache_misses
+              << " cache_writes=" << status.cache_writes << " cache_spills=" << status.cache_spills
+              << " cache_used=" << status.cache_used << " lookaside_used=" << status.lookaside_used.current << "/"
+              << status.lookaside_used.highwater << " lookaside_hits=" << status.lookaside_hits
+              << " lookaside_misses_size=" << status.lookaside_misses_size
+              << " lookaside_misses_full=" << status.lookaside_misses_full << " schema_used=" << status.schema_used
+              << " statements_used=" << status.statements_used;
+  }
+
+  // Accumulates statement status per statement type (select, insert, ...)
+  class statement_status_report_t
+  {
+    std::map<std::string_view, statement_status_t> _totals;
+
+  public:
+    // Resets the statement's counters by default, so that it can be added again later
+    template <typename PreparedStatement>
+    auto add(PreparedStatement& statement, bool reset = true) -> void
+    {
+      _totals[statement_type_name<typename PreparedStatement::result_type>()] +=
+          reset ? statement.reset_status() : statement.status();
+    }
+
+    [[nodiscard]] auto& totals() const
+    {
+      return _totals;
+    }
+
+    auto dump(std::ostream& os) const -> void
+    {
+      for (const auto& [type, status] : _totals)
+      {
+        os << type << ": " << status << '\n';
+      }
+    }
+  };
+}  // namespace sqlpp::sqlite3
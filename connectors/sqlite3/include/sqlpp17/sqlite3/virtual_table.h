@@ -0,0 +1,513 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifdef SQLPP_USE_SQLCIPHER
+#include <sqlcipher/sqlite3.h>
+#else
+#include <sqlite3.h>
+#endif
+
+#include <sqlpp17/data_types.h>
+#include <sqlpp17/exception.h>
+#include <sqlpp17/table.h>
+#include <sqlpp17/type_traits.h>
+
+#include <sqlpp17/sqlite3/context.h>
+#include <sqlpp17/sqlite3/value_type_to_sql_string.h>
+
+/* Exposes an in-memory range of structs as an sqlite3 virtual table.
+   The struct needs a member for each column of the table spec, named like the column's C++ name, e.g.
+
+     struct department
+     {
+       std::int64_t id;
+       std::optional<std::string> name;
+       std::string division;
+     };
+
+   The range is not copied. It has to outlive the virtual table and must not be modified while
+   a query is reading from it. Equality and range constraints are pushed down into the scan.
+*/
+
+namespace sqlpp::sqlite3::detail
+{
+  enum class vtab_op
+  {
+    eq,
+    gt,
+    ge,
+    lt,
+    le
+  };
+
+  [[nodiscard]] inline auto to_vtab_op(unsigned char op) -> std::optional<vtab_op>
+  {
+    switch (op)
+    {
+      case SQLITE_INDEX_CONSTRAINT_EQ:
+        return vtab_op::eq;
+      case SQLITE_INDEX_CONSTRAINT_GT:
+        return vtab_op::gt;
+      case SQLITE_INDEX_CONSTRAINT_GE:
+        return vtab_op::ge;
+      case SQLITE_INDEX_CONSTRAINT_LT:
+        return vtab_op::lt;
+      case SQLITE_INDEX_CONSTRAINT_LE:
+        return vtab_op::le;
+      default:
+        return std::nullopt;
+    }
+  }
+
+  // A copy of the right hand side of a constraint (argv values passed to xFilter die with the call)
+  struct vtab_value_t
+  {
+    int type = SQLITE_NULL;
+    std::int64_t integer = 0;
+    double real = 0.0;
+    std::string text;
+
+    vtab_value_t() = default;
+    explicit vtab_value_t(sqlite3_value* value) : type(sqlite3_value_type(value))
+    {
+      switch (type)
+      {
+        case SQLITE_INTEGER:
+          integer = sqlite3_value_int64(value);
+          real = static_cast<double>(integer);
+          break;
+        case SQLITE_FLOAT:
+          real = sqlite3_value_double(value);
+          break;
+        case SQLITE_TEXT:
+          text.assign(reinterpret_cast<const char*>(sqlite3_value_text(value)),
+                      static_cast<std::size_t>(sqlite3_value_bytes(value)));
+          break;
+      }
+    }
+  };
+
+  struct vtab_constraint_t
+  {
+    int column;
+    vtab_op op;
+    vtab_value_t value;
+  };
+
+  [[nodiscard]] inline auto satisfies(int comparison, vtab_op op) -> bool
+  {
+    switch (op)
+    {
+      case vtab_op::eq:
+        return comparison == 0;
+      case vtab_op::gt:
+        return comparison > 0;
+      case vtab_op::ge:
+        return comparison >= 0;
+      case vtab_op::lt:
+        return comparison < 0;
+      case vtab_op::le:
+        return comparison <= 0;
+    }
+    return true;
+  }
+
+  template <typename T>
+  [[nodiscard]] auto three_way(const T& lhs, const T& rhs) -> int
+  {
+    return (lhs < rhs) ? -1 : ((rhs < lhs) ? 1 : 0);
+  }
+
+  // Returns false only if sqlite3 would certainly reject the row, too.
+  // Constraints are not omitted in xBestIndex, so sqlite3 double-checks everything that passes here.
+  template <typename Field>
+  [[nodiscard]] auto field_may_satisfy(const Field& field, const vtab_constraint_t& constraint) -> bool
+  {
+    if constexpr (::sqlpp::is_optional_v<Field>)
+    {
+      return field.has_value() and field_may_satisfy(*field, constraint);
+    }
+    else if constexpr (std::is_arithmetic_v<Field>)
+    {
+      switch (constraint.value.type)
+      {
+        case SQLITE_NULL:
+          return false;
+        case SQLITE_INTEGER:
+          if constexpr (std::is_integral_v<Field>)
+            return satisfies(three_way(static_cast<std::int64_t>(field), constraint.value.integer), constraint.op);
+          [[fallthrough]];
+        case SQLITE_FLOAT:
+          return satisfies(three_way(static_cast<double>(field), constraint.value.real), constraint.op);
+        default:
+          return true;
+      }
+    }
+    else if constexpr (std::is_convertible_v<const Field&, std::string_view>)
+    {
+      switch (constraint.value.type)
+      {
+        case SQLITE_NULL:
+          return false;
+        case SQLITE_TEXT:
+          return satisfies(std::string_view{field}.compare(constraint.value.text), constraint.op);
+        default:
+          return true;
+      }
+    }
+    else
+    {
+      static_assert(wrong<Field>, "Unsupported field type in virtual table row");
+    }
+  }
+
+  template <typename Field>
+  auto result_field(sqlite3_context* context, const Field& field) -> void
+  {
+    if constexpr (::sqlpp::is_optional_v<Field>)
+    {
+      field ? result_field(context, *field) : sqlite3_result_null(context);
+    }
+    else if constexpr (std::is_integral_v<Field>)
+    {
+      sqlite3_result_int64(context, static_cast<sqlite3_int64>(field));
+    }
+    else if constexpr (std::is_floating_point_v<Field>)
+    {
+      sqlite3_result_double(context, static_cast<double>(field));
+    }
+    else if constexpr (std::is_convertible_v<const Field&, std::string_view>)
+    {
+      const auto text = std::string_view{field};
+      // The range outlives the query, no need to copy
+      sqlite3_result_text(context, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+    }
+    else
+    {
+      static_assert(wrong<Field>, "Unsupported field type in virtual table row");
+    }
+  }
+
+  template <typename TableSpec, typename ColumnSpecs>
+  struct virtual_table_columns;
+
+  template <typename TableSpec, typename... ColumnSpecs>
+  struct virtual_table_columns<TableSpec, ::sqlpp::type_vector<ColumnSpecs...>>
+  {
+    static constexpr auto size = sizeof...(ColumnSpecs);
+
+    [[nodiscard]] static auto declaration() -> std::string
+    {
+      auto context = ::sqlpp::sqlite3::context_t{};
+      auto ret = std::string{"CREATE TABLE x("};
+      auto index = std::size_t{};
+      (..., (ret += (index++ ? ", " : "") + std::string(name_tag_of_t<ColumnSpecs>::name) +
+                    value_type_to_sql_string(context, type_t<typename ColumnSpecs::value_type>{})));
+      return ret + ")";
+    }
+
+    // Text columns are compared in C++ using binary collation
+    [[nodiscard]] static auto is_text_column(int column) -> bool
+    {
+      auto index = 0;
+      return (false or ... or (index++ == column and ::sqlpp::is_text_v<typename ColumnSpecs::value_type>));
+    }
+
+    [[nodiscard]] static auto is_unique_column(int column) -> bool
+    {
+      auto index = 0;
+      return (false or ... or (index++ == column and std::is_same_v<typename TableSpec::primary_key,
+                                                                       ::sqlpp::type_vector<ColumnSpecs>>));
+    }
+
+    template <typename Row>
+    static auto result(sqlite3_context* context, const Row& row, int column) -> void
+    {
+      auto index = 0;
+      (void)(... or (index++ == column and
+                     (result_field(context, name_tag_of_t<ColumnSpecs>::_sqlpp_get(row)), true)));
+    }
+
+    template <typename Row>
+    [[nodiscard]] static auto may_satisfy(const Row& row, const vtab_constraint_t& constraint) -> bool
+    {
+      auto index = 0;
+      auto ret = true;
+      (void)(... or (index++ == constraint.column and
+                     (ret = field_may_satisfy(name_tag_of_t<ColumnSpecs>::_sqlpp_get(row), constraint), true)));
+      return ret;
+    }
+  };
+
+  template <typename TableSpec, typename Range>
+  struct virtual_table_module_t
+  {
+    using _columns = virtual_table_columns<TableSpec, typename TableSpec::_columns>;
+    using _iterator = decltype(std::cbegin(std::declval<const Range&>()));
+
+    struct vtab_t : public ::sqlite3_vtab
+    {
+      const Range* rows = nullptr;
+    };
+
+    struct cursor_t : public ::sqlite3_vtab_cursor
+    {
+      const Range* rows = nullptr;
+      _iterator current;
+      _iterator end;
+      sqlite3_int64 rowid = 0;
+      std::vector<vtab_constraint_t> constraints;
+
+      auto matches() const -> bool
+      {
+        for (const auto& constraint : constraints)
+        {
+          if (not _columns::may_satisfy(*current, constraint))
+            return false;
+        }
+        return true;
+      }
+
+      auto skip_mismatches() -> void
+      {
+        while (current != end and not matches())
+        {
+          ++current;
+          ++rowid;
+        }
+      }
+    };
+
+    static auto connect(::sqlite3* db, void* client_data, int, const char* const*, sqlite3_vtab** vtab, char** error)
+        -> int
+    {
+      if (const auto rc = sqlite3_declare_vtab(db, _columns::declaration().c_str()); rc != SQLITE_OK)
+      {
+        *error = sqlite3_mprintf("%s", sqlite3_errmsg(db));
+        return rc;
+      }
+
+      auto* table = new vtab_t{};
+      table->rows = static_cast<const Range*>(client_data);
+      *vtab = table;
+      return SQLITE_OK;
+    }
+
+    static auto disconnect(sqlite3_vtab* vtab) -> int
+    {
+      delete static_cast<vtab_t*>(vtab);
+      return SQLITE_OK;
+    }
+
+    // Constraints are passed to filter() encoded as "column:op;column:op;..." in idxStr
+    static auto best_index(sqlite3_vtab* vtab, sqlite3_index_info* info) -> int
+    {
+      const auto row_count = static_cast<double>(std::size(*static_cast<vtab_t*>(vtab)->rows));
+
+      auto encoded = std::string{};
+      auto estimated_rows = row_count;
+      auto unique = false;
+      auto argv_index = 0;
+      for (auto i = 0; i < info->nConstraint; ++i)
+      {
+        const auto& constraint = info->aConstraint[i];
+        const auto op = to_vtab_op(constraint.op);
+        if (not constraint.usable or not op or constraint.iColumn < 0)
+          continue;
+        if (_columns::is_text_column(constraint.iColumn) and
+            std::string_view{sqlite3_vtab_collation(info, i)}.compare("BINARY") != 0)
+          continue;
+
+        info->aConstraintUsage[i].argvIndex = ++argv_index;
+        info->aConstraintUsage[i].omit = false;
+        encoded += std::to_string(constraint.iColumn) + ":" + std::to_string(static_cast<int>(*op)) + ";";
+
+        if (*op == vtab_op::eq)
+        {
+          estimated_rows /= 10;
+          unique = unique or _columns::is_unique_column(constraint.iColumn);
+        }
+        else
+        {
+          estimated_rows /= 3;
+        }
+      }
+
+      if (unique)
+      {
+        estimated_rows = 1;
+        info->idxFlags |= SQLITE_INDEX_SCAN_UNIQUE;
+      }
+
+      info->idxNum = argv_index;
+      info->idxStr = sqlite3_mprintf("%s", encoded.c_str());
+      info->needToFreeIdxStr = true;
+      // Scanning in C++ is cheap compared to handing rows to the sqlite3 VM
+      info->estimatedCost = row_count / 10 + (estimated_rows < 1 ? 1 : estimated_rows);
+      info->estimatedRows = static_cast<sqlite3_int64>(estimated_rows < 1 ? 1 : estimated_rows);
+      return SQLITE_OK;
+    }
+
+    static auto open(sqlite3_vtab* vtab, sqlite3_vtab_cursor** cursor) -> int
+    {
+      auto* c = new cursor_t{};
+      c->rows = static_cast<vtab_t*>(vtab)->rows;
+      c->current = std::cbegin(*c->rows);
+      c->end = std::cend(*c->rows);
+      *cursor = c;
+      return SQLITE_OK;
+    }
+
+    static auto close(sqlite3_vtab_cursor* cursor) -> int
+    {
+      delete static_cast<cursor_t*>(cursor);
+      return SQLITE_OK;
+    }
+
+    static auto filter(sqlite3_vtab_cursor* cursor, int, const char* idx_str, int argc, sqlite3_value** argv) -> int
+    {
+      auto* c = static_cast<cursor_t*>(cursor);
+      c->constraints.clear();
+      for (auto i = 0; i < argc and idx_str and *idx_str; ++i)
+      {
+        char* end = nullptr;
+        const auto column = static_cast<int>(std::strtol(idx_str, &end, 10));
+        const auto op = static_cast<vtab_op>(std::strtol(end + 1, &end, 10));
+        idx_str = end + 1;
+        c->constraints.push_back(vtab_constraint_t{column, op, vtab_value_t{argv[i]}});
+      }
+
+      c->current = std::cbegin(*c->rows);
+      c->end = std::cend(*c->rows);
+      c->rowid = 0;
+      c->skip_mismatches();
+      return SQLITE_OK;
+    }
+
+    static auto next(sqlite3_vtab_cursor* cursor) -> int
+    {
+      auto* c = static_cast<cursor_t*>(cursor);
+      ++c->current;
+      ++c->rowid;
+      c->skip_mismatches();
+      return SQLITE_OK;
+    }
+
+    static auto eof(sqlite3_vtab_cursor* cursor) -> int
+    {
+      auto* c = static_cast<cursor_t*>(cursor);
+      return c->current == c->end;
+    }
+
+    static auto column(sqlite3_vtab_cursor* cursor, sqlite3_context* context, int column) -> int
+    {
+      auto* c = static_cast<cursor_t*>(cursor);
+      _columns::result(context, *c->current, column);
+      return SQLITE_OK;
+    }
+
+    static auto rowid(sqlite3_vtab_cursor* cursor, sqlite3_int64* rowid) -> int
+    {
+      *rowid = static_cast<cursor_t*>(cursor)->rowid;
+      return SQLITE_OK;
+    }
+
+    static auto get() -> const sqlite3_module*
+    {
+      static const auto module = []() {
+        auto m = sqlite3_module{};
+        m.iVersion = 1;
+        m.xCreate = &connect;
+        m.xConnect = &connect;
+        m.xBestIndex = &best_index;
+        m.xDisconnect = &disconnect;
+        m.xDestroy = &disconnect;
+        m.xOpen = &open;
+        m.xClose = &close;
+        m.xFilter = &filter;
+        m.xNext = &next;
+        m.xEof = &eof;
+        m.xColumn = &column;
+        m.xRowid = &rowid;
+        return m;
+      }();
+      return &module;
+    }
+  };
+
+  template <typename TableSpec>
+  [[nodiscard]] auto virtual_table_module_name() -> std::string
+  {
+    return "sqlpp17_" + std::string(name_tag_of_t<TableSpec>::name);
+  }
+}  // namespace sqlpp::sqlite3::detail
+
+namespace sqlpp::sqlite3
+{
+  // Creates temp.<table name> as a virtual table, reading from `rows`
+  template <typename Connection, typename TableSpec, typename Range>
+  auto create_virtual_table(Connection& connection, const ::sqlpp::table_t<TableSpec>&, const Range& rows) -> void
+  {
+    const auto module_name = detail::virtual_table_module_name<TableSpec>();
+    const auto rc = sqlite3_create_module_v2(connection.get(), module_name.c_str(),
+                                             detail::virtual_table_module_t<TableSpec, Range>::get(),
+                                             const_cast<Range*>(&rows), nullptr);
+    if (rc != SQLITE_OK)
+    {
+      throw sqlpp::exception("Sqlite3: Could not create module " + module_name + ": " +
+                             std::string(sqlite3_errmsg(connection.get())));
+    }
+
+    connection("CREATE VIRTUAL TABLE temp." + std::string(name_tag_of_t<TableSpec>::name) + " USING " +
+               module_name);
+  }
+
+  // Drops the virtual table and its module, e.g. to re-create it for another range
+  template <typename Connection, typename TableSpec>
+  auto drop_virtual_table(Connection& connection, const ::sqlpp::table_t<TableSpec>&) -> void
+  {
+    connection("DROP TABLE IF EXISTS temp." + std::string(name_tag_of_t<TableSpec>::name));
+
+    const auto module_name = detail::virtual_table_module_name<TableSpec>();
+    const auto rc = sqlite3_create_module_v2(connection.get(), module_name.c_str(), nullptr, nullptr, nullptr);
+    if (rc != SQLITE_OK)
+    {
+      throw sqlpp::exception("Sqlite3: Could not drop module " + module_name + ": " +
+                             std::string(sqlite3_errmsg(connection.get())));
+    }
+  }
+}  // namespace sqlpp::sqlite3
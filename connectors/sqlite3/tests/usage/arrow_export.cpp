@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <sqlpp17/arrow_export.h>
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+#include <sqlpp17_test/tables/TabFloat.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  auto is_valid(const ArrowArray& array, int index) -> bool
+  {
+    const auto* validity = static_cast<const std::uint8_t*>(array.buffers[0]);
+    return not validity or (validity[index / 8] >> (index % 8)) & 1;
+  }
+
+  auto text_at(const ArrowArray& array, int index) -> std::string
+  {
+    const auto* offsets = static_cast<const std::int32_t*>(array.buffers[1]);
+    const auto* data = static_cast<const char*>(array.buffers[2]);
+    return std::string(data + offsets[index], data + offsets[index + 1]);
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("INSERT INTO tab_department (name) VALUES ('first'), (NULL), ('third')");
+
+    auto result = db(::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name)
+                         .from(::test::tabDepartment)
+                         .where(::test::tabDepartment.id > 0)
+                         .order_by(::test::tabDepartment.id.asc()));
+
+    auto schema = ArrowSchema{};
+    ::sqlpp::arrow::export_schema(result, &schema);
+    expect(std::strcmp(schema.format, "+s") == 0 and schema.n_children == 2, "unexpected schema");
+    expect(std::strcmp(schema.children[0]->format, "l") == 0 and std::strcmp(schema.children[0]->name, "id") == 0 and
+               schema.children[0]->flags == 0,
+           "unexpected id schema");
+    expect(std::strcmp(schema.children[1]->format, "u") == 0 and std::strcmp(schema.children[1]->name, "name") == 0 and
+               schema.children[1]->flags == ARROW_FLAG_NULLABLE,
+           "unexpected name schema");
+    schema.release(&schema);
+    expect(schema.release == nullptr, "expected release to mark the schema as released");
+
+    auto batch = ArrowArray{};
+    expect(::sqlpp::arrow::export_batch(result, 2, &batch) == 2, "expected a batch of two rows");
+    expect(batch.length == 2 and batch.n_children == 2 and batch.n_buffers == 1, "unexpected struct array");
+    const auto& ids = *batch.children[0];
+    const auto& names = *batch.children[1];
+    expect(ids.null_count == 0 and ids.buffers[0] == nullptr, "expected no validity bitmap for ids");
+    expect(static_cast<const std::int64_t*>(ids.buffers[1])[1] == 2, "unexpected id");
+    expect(names.null_count == 1 and is_valid(names, 0) and not is_valid(names, 1), "unexpected validity of names");
+    expect(text_at(names, 0) == "first" and text_at(names, 1).empty(), "unexpected names");
+
+    // Consumers may move children out before releasing the parent
+    auto moved_names = *batch.children[1];
+    batch.children[1]->release = nullptr;
+    batch.release(&batch);
+    expect(text_at(moved_names, 0) == "first", "expected moved child to stay valid");
+    moved_names.release(&moved_names);
+
+    expect(::sqlpp::arrow::export_batch(result, 2, &batch) == 1, "expected the last row");
+    expect(text_at(*batch.children[1], 0) == "third", "unexpected last name");
+    batch.release(&batch);
+
+    expect(::sqlpp::arrow::export_batch(result, 2, &batch) == 0 and batch.length == 0, "expected an empty batch");
+    batch.release(&batch);
+
+    db("DROP TABLE IF EXISTS tab_float");
+    db("CREATE TABLE tab_float (id INTEGER PRIMARY KEY AUTOINCREMENT, value_float REAL NOT NULL, "
+       "value_double REAL NOT NULL, value_int INTEGER NOT NULL)");
+    db("INSERT INTO tab_float (value_float, value_double, value_int) VALUES (1.5, 2.5, 7)");
+    auto floats = db(::sqlpp::select(::test::tabFloat.valueFloat, ::test::tabFloat.valueDouble, ::test::tabFloat.valueInt)
+                         .from(::test::tabFloat)
+                         .where(::test::tabFloat.id > 0));
+    ::sqlpp::arrow::export_schema(floats, &schema);
+    expect(std::strcmp(schema.children[0]->format, "f") == 0 and std::strcmp(schema.children[1]->format, "g") == 0 and
+               std::strcmp(schema.children[2]->format, "i") == 0,
+           "unexpected numeric formats");
+    schema.release(&schema);
+    expect(::sqlpp::arrow::export_batch(floats, 10, &batch) == 1, "expected one row");
+    expect(static_cast<const double*>(batch.children[1]->buffers[1])[0] == 2.5 and
+               static_cast<const std::int32_t*>(batch.children[2]->buffers[1])[0] == 7,
+           "unexpected numeric values");
+    batch.release(&batch);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
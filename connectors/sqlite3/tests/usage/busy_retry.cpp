@@ -0,0 +1,221 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  const auto database_path = std::string{"sqlpp17_busy_retry_test"};
+
+  auto make_config()
+  {
+    auto config = ::sqlpp::sqlite3::connection_config_t{};
+    config.path_to_database = database_path;
+    config.flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    return config;
+  }
+
+  using ::sqlpp::test::expect;
+
+  // Holds an exclusive lock on the database for the given duration
+  template <typename Connection>
+  auto lock_for(Connection& db, std::chrono::milliseconds duration)
+  {
+    db("BEGIN EXCLUSIVE");
+    return std::thread{[&db, duration]() {
+      std::this_thread::sleep_for(duration);
+      db("COMMIT");
+    }};
+  }
+
+  auto fails(const std::function<void()>& f) -> bool
+  {
+    try
+    {
+      f();
+    }
+    catch (const sqlpp::exception&)
+    {
+      return true;
+    }
+    return false;
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    std::remove(database_path.c_str());
+    auto locker = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{make_config()};
+    ::sqlpp::sqlite3::test::create_tab_department(locker);
+
+    // Without a retry policy, a locked database is reported immediately
+    {
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{make_config()};
+      auto select = db.prepare(sqlpp::select(test::tabDepartment.id).from(test::tabDepartment).unconditionally());
+      auto thread = lock_for(locker, std::chrono::milliseconds{100});
+      expect(fails([&db]() { db("INSERT INTO tab_department (name) VALUES ('Sales')"); }), "expected SQLITE_BUSY");
+      // busy while stepping, not while preparing
+      const auto select_failed = fails([&select]() {
+        for ([[maybe_unused]] const auto& row : select.execute())
+        {
+        }
+      });
+      thread.join();
+      expect(select_failed, "expected SQLITE_BUSY when stepping");
+      expect(db.busy_statistics().busy_events == 0, "no busy events without policy");
+    }
+
+    // With a retry policy, writes and reads succeed once the lock is released
+    {
+      auto config = make_config();
+      config.busy_retry = ::sqlpp::sqlite3::busy_retry_policy_t{};
+      config.busy_retry->max_wait = std::chrono::seconds{2};
+      config.busy_statistics = std::make_shared<::sqlpp::sqlite3::busy_statistics_t>();
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+
+      auto thread = lock_for(locker, std::chrono::milliseconds{50});
+      db("INSERT INTO tab_department (name) VALUES ('Sales')");
+      thread.join();
+
+      thread = lock_for(locker, std::chrono::milliseconds{50});
+      auto count = 0;
+      for ([[maybe_unused]] const auto& row :
+           db(sqlpp::select(test::tabDepartment.id).from(test::tabDepartment).unconditionally()))
+      {
+        ++count;
+      }
+      thread.join();
+      expect(count == 1, "unexpected row count");
+
+      const auto& statistics = *config.busy_statistics;
+      expect(&db.busy_statistics() == &statistics, "expected shared statistics");
+      expect(statistics.busy_events == 2, "expected two busy events");
+      expect(statistics.retries > 0, "expected retries");
+      expect(statistics.give_ups == 0, "expected no give ups");
+      expect(statistics.time_waited() >= std::chrono::milliseconds{50}, "expected to wait for the lock");
+    }
+
+    // The maximum wait is respected
+    {
+      auto config = make_config();
+      config.busy_retry = ::sqlpp::sqlite3::busy_retry_policy_t{};
+      config.busy_retry->max_wait = std::chrono::milliseconds{20};
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+
+      auto thread = lock_for(locker, std::chrono::milliseconds{300});
+      const auto start = std::chrono::steady_clock::now();
+      expect(fails([&db]() { db("INSERT INTO tab_department (name) VALUES ('Marketing')"); }), "expected to give up");
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      thread.join();
+
+      expect(elapsed < std::chrono::milliseconds{250}, "waited too long");
+      expect(db.busy_statistics().give_ups == 1, "expected one give up");
+      expect(db.busy_statistics().time_waited() <= std::chrono::milliseconds{40}, "waited longer than max_wait");
+    }
+
+    // Waiting for a lock stops at the statement deadline
+    {
+      auto config = make_config();
+      config.busy_retry = ::sqlpp::sqlite3::busy_retry_policy_t{};
+      config.busy_retry->max_wait = std::chrono::seconds{5};
+      config.statement_timeout = std::chrono::milliseconds{50};
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+      auto select = db.prepare(sqlpp::select(test::tabDepartment.id).from(test::tabDepartment).unconditionally());
+
+      auto thread = lock_for(locker, std::chrono::milliseconds{400});
+      const auto start = std::chrono::steady_clock::now();
+      expect(fails([&select]() {
+               for ([[maybe_unused]] const auto& row : select.execute())
+               {
+               }
+             }),
+             "expected to stop waiting at the statement deadline");
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      thread.join();
+
+      expect(elapsed < std::chrono::milliseconds{250}, "waited beyond the statement deadline");
+      expect(db.busy_statistics().give_ups == 0, "expected the deadline, not max_wait, to end waiting");
+    }
+
+    // ... and at the connection's deadline, also while preparing
+    {
+      auto config = make_config();
+      config.busy_retry = ::sqlpp::sqlite3::busy_retry_policy_t{};
+      config.busy_retry->max_wait = std::chrono::seconds{5};
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+
+      auto thread = lock_for(locker, std::chrono::milliseconds{400});
+      const auto start = std::chrono::steady_clock::now();
+      db.set_deadline(start + std::chrono::milliseconds{50});
+      expect(fails([&db]() { db("INSERT INTO tab_department (name) VALUES ('Marketing')"); }),
+             "expected to stop waiting at the deadline");
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      thread.join();
+      db.clear_deadline();
+
+      expect(elapsed < std::chrono::milliseconds{250}, "waited beyond the deadline");
+    }
+
+    // Retrying a statement after sqlite3 gave up continues with the same lock
+    {
+      auto policy = ::sqlpp::sqlite3::busy_retry_policy_t{};
+      policy.initial_delay = std::chrono::milliseconds{6};
+      policy.max_delay = std::chrono::milliseconds{6};
+      policy.jitter = 0.0;
+      policy.max_wait = std::chrono::milliseconds{10};
+      const auto statistics = std::make_shared<::sqlpp::sqlite3::busy_statistics_t>();
+      auto handler = ::sqlpp::sqlite3::detail::busy_handler_t{policy, statistics};
+
+      handler.begin_step();
+      expect(handler.wait(0), "expected sqlite3 to wait for the lock");
+      expect(not handler.retry(), "expected the retry to exceed max_wait");
+      handler.end_step();
+      expect(statistics->busy_events == 1, "expected the lock to be counted once");
+      expect(statistics->retries == 1 and statistics->give_ups == 1, "expected one retry and one give up");
+    }
+
+    std::remove(database_path.c_str());
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -46,15 +46,17 @@ int main()
   {
     auto config = ::sqlpp::sqlite3::test::get_config();
     config.post_connect = post_connect;
-    auto pool = ::sqlpp::sqlite3::connection_pool_t<::sqlpp::debug::allowed>{5, config};
+    auto pool = ::sqlpp::sqlite3::connection_pool_t<::sqlpp::debug::allowed>{50, config};
 
     ::sqlpp::test::test_basic_functionality(pool);
     ::sqlpp::test::test_single_connection(pool);
     ::sqlpp::test::test_multiple_connections(pool);
+    ::sqlpp::test::test_bounded_capacity(pool);
 
     if (sqlite3_threadsafe())
     {
       ::sqlpp::test::test_multithreaded(pool);
+      ::sqlpp::test::test_fifo_waiters(pool);
     }
     else
     {
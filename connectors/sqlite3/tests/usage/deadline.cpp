@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+
+#include <sqlpp17_test/expect.h>
+
+namespace
+{
+  const auto runaway_query =
+      std::string{"WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c) SELECT count(*) FROM c"};
+
+  using ::sqlpp::test::expect;
+
+  template <typename Exception>
+  auto throws(const std::function<void()>& f) -> bool
+  {
+    try
+    {
+      f();
+    }
+    catch (const Exception&)
+    {
+      return true;
+    }
+    return false;
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    // Per-statement timeout
+    {
+      auto config = ::sqlpp::sqlite3::test::get_config();
+      config.statement_timeout = std::chrono::milliseconds{50};
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+
+      const auto start = std::chrono::steady_clock::now();
+      expect(throws<::sqlpp::sqlite3::deadline_exceeded_exception>([&db]() { db(runaway_query); }),
+             "expected deadline_exceeded_exception");
+      expect(std::chrono::steady_clock::now() - start < std::chrono::seconds{5}, "deadline was not enforced");
+
+      // The next statement gets a new deadline
+      std::this_thread::sleep_for(std::chrono::milliseconds{60});
+      db("SELECT 1");
+
+      // The deadline ends with the statement, it does not affect statements run outside of sqlpp
+      std::this_thread::sleep_for(std::chrono::milliseconds{60});
+      expect(sqlite3_exec(db.get(),
+                          "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c LIMIT 100000) "
+                          "SELECT count(*) FROM c",
+                          nullptr, nullptr, nullptr) == SQLITE_OK,
+             "expected the statement deadline to be disarmed");
+    }
+
+    // Cancellation from another thread
+    {
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{::sqlpp::sqlite3::test::get_config()};
+      auto thread = std::thread{[&db]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        db.cancel();
+      }};
+      const auto cancelled = throws<::sqlpp::sqlite3::cancelled_exception>([&db]() { db(runaway_query); });
+      thread.join();
+      expect(cancelled, "expected cancelled_exception");
+
+      // Cancellation does not affect later statements
+      db("SELECT 1");
+
+      // Cancelling between statements cancels the next one
+      db.cancel();
+      expect(throws<::sqlpp::sqlite3::cancelled_exception>([&db]() { db("SELECT 1"); }),
+             "expected an early cancel() to cancel the next statement");
+      db("SELECT 1");
+    }
+
+    // Explicit deadline spanning several statements
+    {
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{::sqlpp::sqlite3::test::get_config()};
+      db.set_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds{50});
+      db("SELECT 1");
+      expect(throws<::sqlpp::sqlite3::interrupted_exception>([&db]() { db(runaway_query); }),
+             "expected interrupted_exception");
+      expect(throws<::sqlpp::sqlite3::deadline_exceeded_exception>([&db]() { db(runaway_query); }),
+             "expected deadline to stay exceeded");
+
+      db.clear_deadline();
+      db("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c LIMIT 100000) SELECT count(*) FROM c");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("INSERT INTO tab_department (name) VALUES ('first'), (NULL), ('third'), ('fourth'), ('fifth')");
+
+    const auto select_all = [&db]() {
+      return db(::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name)
+                    .from(::test::tabDepartment)
+                    .where(::test::tabDepartment.id > 0)
+                    .order_by(::test::tabDepartment.id.asc()));
+    };
+
+    // Fetched rows own their values
+    {
+      auto result = select_all();
+      expect(not result.size_hint() and not result.byte_size_hint(), "expected no hints for stepped results");
+      auto rows = result.fetch(2);
+      static_assert(std::is_same_v<decltype(rows.front().name), std::optional<std::string>>);
+      expect(rows.size() == 2, "expected two rows");
+      expect(rows[0].id == 1 and rows[0].name == std::string("first"), "unexpected first row");
+      expect(rows[1].id == 2 and not rows[1].name, "expected the second name to be null");
+
+      auto rest = result.fetch_all();
+      expect(rest.size() == 3, "expected the remaining three rows");
+      expect(rest.back().id == 5 and rest.back().name == std::string("fifth"), "unexpected last row");
+      expect(result.fetch(10).empty(), "expected the result to be exhausted");
+    }
+
+    // Fetching continues after the rows that were already iterated
+    {
+      auto result = select_all();
+      expect(result.front().id == 1, "unexpected front row");
+      auto rows = result.fetch(10);
+      expect(rows.size() == 4, "expected the remaining four rows");
+      expect(rows.front().id == 2, "expected fetch to continue after the current row");
+    }
+
+    {
+      db("DELETE FROM tab_department");
+      auto result = select_all();
+      expect(result.fetch_all().empty(), "expected no rows");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,168 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <string>
+
+#include <sqlpp17/clause/insert_into.h>
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/name_tag.h>
+#include <sqlpp17/parameter.h>
+
+#include <sqlpp17/sqlite3/connection_pool.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+SQLPP_CREATE_NAME_TAG(pName);
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  template <typename PreparedStatement>
+  auto run(PreparedStatement& statement)
+  {
+    auto count = 0;
+    for ([[maybe_unused]] const auto& row : statement.execute())
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  auto select_by_name()
+  {
+    return sqlpp::select(::test::tabDepartment.id)
+        .from(::test::tabDepartment)
+        .where(::test::tabDepartment.name == ::sqlpp::parameter<std::string>(pName));
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    {
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+      db("DROP TABLE IF EXISTS tab_department");
+      db("CREATE TABLE tab_department (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT CHECK (name <> 'invalid'), "
+         "division TEXT NOT NULL DEFAULT 'engineering')");
+      db("INSERT INTO tab_department (name) VALUES ('first'), ('second'), ('second')");
+
+      // Unpooled connections have their own registry
+      auto* cached_statement = static_cast<::sqlite3_stmt*>(nullptr);
+      {
+        auto first = db.prepare_cached(select_by_name());
+        first.parameters.pName = "second";
+        expect(run(first) == 2, "unexpected row count");
+        cached_statement = first.get();
+
+        // A statement in use is not shared
+        auto second = db.prepare_cached(select_by_name());
+        expect(second.get() != first.get(), "expected a statement of its own while the cached one is in use");
+        second.parameters.pName = "first";
+        expect(run(second) == 1, "unexpected row count");
+        expect(run(first) == 2, "expected the first statement to be unaffected by the second");
+      }
+      auto third = db.prepare_cached(select_by_name());
+      expect(third.get() == cached_statement, "expected the native statement to be reused");
+      expect(db.statements().size() == 1 and db.statements().hits() == 2, "expected one cached statement");
+    }
+
+    auto pool = ::sqlpp::sqlite3::connection_pool_t<::sqlpp::debug::allowed>{1, config};
+    auto* native_statement = static_cast<::sqlite3_stmt*>(nullptr);
+    {
+      auto db = pool.get();
+      auto statement = db.prepare_cached(select_by_name());
+      statement.parameters.pName = "first";
+      expect(run(statement) == 1, "unexpected row count");
+      native_statement = statement.get();
+    }
+
+    // The next borrower of the same physical connection finds the statement
+    {
+      auto db = pool.get();
+      expect(db.statements().size() == 1, "expected the registry to survive the checkout");
+      auto statement = db.prepare_cached(select_by_name());
+      expect(statement.get() == native_statement, "expected the native statement to be reused");
+      statement.parameters.pName = "second";
+      expect(run(statement) == 2, "unexpected row count");
+      expect(db.statements().misses() == 1, "expected the statement to be prepared once");
+    }
+
+    // A failed step of one borrower does not affect the next one
+    {
+      auto db = pool.get();
+      auto statement = db.prepare_cached(
+          insert_into(::test::tabDepartment).set(::test::tabDepartment.name = ::sqlpp::parameter<std::string>(pName)));
+      statement.parameters.pName = "invalid";
+      try
+      {
+        statement.execute();
+        throw std::logic_error("expected the check constraint to fail");
+      }
+      catch (const ::sqlpp::exception&)
+      {
+      }
+      native_statement = statement.get();
+    }
+    {
+      auto db = pool.get();
+      auto statement = db.prepare_cached(
+          insert_into(::test::tabDepartment).set(::test::tabDepartment.name = ::sqlpp::parameter<std::string>(pName)));
+      expect(statement.get() == native_statement, "expected the native statement to be reused");
+      statement.parameters.pName = "third";
+      statement.execute();
+      auto select = db.prepare_cached(select_by_name());
+      select.parameters.pName = "third";
+      expect(run(select) == 1, "expected the insert to succeed");
+    }
+
+    // Preparation errors are not cached
+    {
+      auto db = pool.get();
+      db("DROP TABLE tab_department");
+      db.statements().clear();
+      try
+      {
+        [[maybe_unused]] auto statement = db.prepare_cached(select_by_name());
+        throw std::logic_error("expected preparation to fail after the table is dropped");
+      }
+      catch (const ::sqlpp::exception&)
+      {
+      }
+      expect(db.statements().size() == 0, "expected failed preparation not to be cached");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
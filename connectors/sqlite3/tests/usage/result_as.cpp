@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  struct department_t
+  {
+    std::int64_t id = 0;
+    std::optional<std::string> name;
+    std::string division;
+    int unrelated = 42;
+  };
+
+  template <typename Db>
+  auto select_all(Db& db)
+  {
+    return db(::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name, ::test::tabDepartment.division)
+                  .from(::test::tabDepartment)
+                  .where(::test::tabDepartment.id > 0)
+                  .order_by(::test::tabDepartment.id.asc()));
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("INSERT INTO tab_department (name, division) VALUES ('first', 'sales'), (NULL, 'ops'), ('third', 'r&d')");
+
+    {
+      const auto departments = select_all(db).as<department_t>();
+      expect(departments.size() == 3, "expected three departments");
+      expect(departments[0].id == 1 and departments[0].name == std::string("first") and
+                 departments[0].division == "sales",
+             "unexpected first department");
+      expect(not departments[1].name and departments[1].division == "ops", "expected the second name to be null");
+      expect(departments[2].unrelated == 42, "expected members without column to be left alone");
+    }
+
+    // Batches, continuing after rows consumed otherwise
+    {
+      auto result = select_all(db);
+      expect(result.front().id == 1, "unexpected front row");
+      const auto batch = result.as<department_t>(1);
+      expect(batch.size() == 1 and batch[0].id == 2, "unexpected batch");
+      const auto rest = result.as<department_t>();
+      expect(rest.size() == 1 and rest[0].name == std::string("third"), "unexpected rest");
+      expect(result.as<department_t>().empty(), "expected the result to be exhausted");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
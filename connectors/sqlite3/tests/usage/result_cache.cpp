@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/result_cache.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+#include <sqlpp17_test/tables/TabFloat.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  auto select_departments()
+  {
+    return ::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name, ::test::tabDepartment.division)
+        .from(::test::tabDepartment)
+        .where(::test::tabDepartment.id > 0)
+        .order_by(::test::tabDepartment.id.asc());
+  }
+
+  auto select_floats()
+  {
+    return ::sqlpp::select(::test::tabFloat.valueDouble, ::test::tabFloat.valueInt)
+        .from(::test::tabFloat)
+        .where(::test::tabFloat.id > 0);
+  }
+
+  template <typename Row>
+  auto expect_open_failure(const std::string& path, const std::string& message) -> void
+  {
+    try
+    {
+      [[maybe_unused]] auto cache = ::sqlpp::result_cache_t<Row>{path};
+    }
+    catch (const ::sqlpp::exception&)
+    {
+      return;
+    }
+    throw std::logic_error(message);
+  }
+
+  using department_row_t = ::sqlpp::result_row_of_t<decltype(select_departments())>;
+  using float_row_t = ::sqlpp::result_row_of_t<decltype(select_floats())>;
+}  // namespace
+
+int main()
+{
+  const auto path = std::string("result_cache_test.sqpc");
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 200) "
+       "INSERT INTO tab_department (name, division) "
+       "SELECT CASE WHEN i % 3 = 0 THEN NULL ELSE 'name_' || i END, 'division_' || (i % 7) FROM n");
+
+    {
+      auto result = db(select_departments());
+      expect(::sqlpp::write_result_cache(result, path) == 200, "expected 200 rows to be written");
+    }
+
+    {
+      const auto cache = ::sqlpp::result_cache_t<department_row_t>{path};
+      expect(cache.size() == 200, "expected 200 cached rows");
+      const auto row = cache[3];
+      expect(row.id == 4 and row.name == std::string_view("name_4") and row.division == std::string_view("division_4"),
+             "unexpected cached row");
+      expect(not cache[2].name, "expected a null name");
+
+      // Same rows as from the database
+      auto result = db(select_departments());
+      auto cached = ::sqlpp::as_result(cache);
+      expect(cached.size_hint() == std::optional<std::size_t>{200}, "expected the row count as size hint");
+      const auto expected = result.fetch_all();
+      const auto actual = cached.fetch_all();
+      expect(actual.size() == expected.size(), "unexpected row count");
+      for (std::size_t i = 0; i < actual.size(); ++i)
+      {
+        expect(actual[i].id == expected[i].id and actual[i].name == expected[i].name and
+                   actual[i].division == expected[i].division,
+               "cached rows differ");
+      }
+    }
+
+    // Rows of a different type are rejected
+    expect_open_failure<float_row_t>(path, "expected a different row type to be rejected");
+
+    // Numeric columns, and an empty result
+    db("DROP TABLE IF EXISTS tab_float");
+    db("CREATE TABLE tab_float (id INTEGER PRIMARY KEY AUTOINCREMENT, value_float REAL NOT NULL, "
+       "value_double REAL NOT NULL, value_int INTEGER NOT NULL)");
+    db("INSERT INTO tab_float (value_float, value_double, value_int) VALUES (1.5, 2.5, 7), (3.5, -4.25, -8)");
+    {
+      auto result = db(select_floats());
+      ::sqlpp::write_result_cache(result, path);
+      const auto cache = ::sqlpp::result_cache_t<float_row_t>{path};
+      expect(cache.size() == 2 and cache[1].valueDouble == -4.25 and cache[1].valueInt == -8,
+             "unexpected numeric row");
+    }
+    // A row count that wraps around when multiplied by the value sizes is rejected
+    {
+      const auto row_count = std::uint64_t{1} << 62;
+      auto file = std::fstream{path, std::ios::binary | std::ios::in | std::ios::out};
+      file.seekp(16);
+      file.write(reinterpret_cast<const char*>(&row_count), sizeof(row_count));
+    }
+    expect_open_failure<float_row_t>(path, "expected an oversized row count to be rejected");
+    db("DELETE FROM tab_department");
+    {
+      auto result = db(select_departments());
+      expect(::sqlpp::write_result_cache(result, path) == 0, "expected no rows");
+      expect(::sqlpp::result_cache_t<department_row_t>{path}.empty(), "expected an empty cache");
+    }
+
+    // Truncated files are rejected
+    {
+      std::ofstream{path, std::ios::binary | std::ios::trunc} << "SQPC";
+      expect_open_failure<department_row_t>(path, "expected a truncated file to be rejected");
+    }
+    std::remove(path.c_str());
+  }
+  catch (const std::exception& e)
+  {
+    std::remove(path.c_str());
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
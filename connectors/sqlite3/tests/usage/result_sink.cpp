@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/result_sink.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  template <typename Db>
+  auto select_all(Db& db)
+  {
+    return db(::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name, ::test::tabDepartment.division)
+                  .from(::test::tabDepartment)
+                  .where(::test::tabDepartment.id > 0)
+                  .order_by(::test::tabDepartment.id.asc()));
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("INSERT INTO tab_department (name, division) VALUES ('plain', 'a,b'), (NULL, 'say \"hi\"'), "
+       "('tab\tline\nend', 'back\\slash')");
+
+    {
+      auto result = select_all(db);
+      auto os = std::ostringstream{};
+      expect(::sqlpp::write_csv(result, os) == 3, "expected three csv rows");
+      expect(os.str() ==
+                 "id,name,division\n"
+                 "1,plain,\"a,b\"\n"
+                 "2,,\"say \"\"hi\"\"\"\n"
+                 "3,\"tab\tline\nend\",back\\slash\n",
+             "unexpected csv: " + os.str());
+    }
+
+    {
+      auto result = select_all(db);
+      auto os = std::ostringstream{};
+      auto options = ::sqlpp::csv_options_t{};
+      options.delimiter = ';';
+      options.header = false;
+      ::sqlpp::write_csv(result, os, options);
+      expect(os.str().substr(0, 14) == "1;plain;a,b\n2;", "unexpected csv with options: " + os.str());
+    }
+
+    {
+      auto result = select_all(db);
+      auto os = std::ostringstream{};
+      expect(::sqlpp::write_json_lines(result, os) == 3, "expected three json lines");
+      expect(os.str() ==
+                 "{\"id\":1,\"name\":\"plain\",\"division\":\"a,b\"}\n"
+                 "{\"id\":2,\"name\":null,\"division\":\"say \\\"hi\\\"\"}\n"
+                 "{\"id\":3,\"name\":\"tab\\tline\\nend\",\"division\":\"back\\\\slash\"}\n",
+             "unexpected json lines: " + os.str());
+    }
+
+    {
+      auto result = select_all(db);
+      auto os = std::ostringstream{};
+      expect(::sqlpp::write_binary(result, os) == 3, "expected three binary rows");
+      const auto binary = os.str();
+      const auto header = std::string("SQPB\x03\0\0\0", 8) + std::string("\x02\0\0\0id\x05\0", 8) +
+                          std::string("\x04\0\0\0name\x0c\x01", 10) + std::string("\x08\0\0\0division\x0c\0", 14);
+      expect(binary.substr(0, header.size()) == header, "unexpected binary header");
+      const auto first_row = std::string("\x01\x01\0\0\0\0\0\0\0\0\x05\0\0\0plain\x03\0\0\0a,b", 26);
+      expect(binary.substr(header.size(), first_row.size()) == first_row, "unexpected first binary row");
+      expect(binary.back() == '\0', "expected the end marker");
+    }
+
+    // File descriptors, with text larger than the buffer
+    {
+      const auto large = std::string(100000, 'x');
+      db("DELETE FROM tab_department");
+      db("INSERT INTO tab_department (name) VALUES ('" + large + "')");
+      auto* file = std::tmpfile();
+      auto result = select_all(db);
+      expect(::sqlpp::write_csv(result, fileno(file)) == 1, "expected one row");
+      std::rewind(file);
+      auto content = std::string(200000, '\0');
+      content.resize(std::fread(content.data(), 1, content.size(), file));
+      std::fclose(file);
+      expect(content == "id,name,division\n4," + large + ",engineering\n", "unexpected file content");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/result_snapshot.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  template <typename Db>
+  auto select_all(Db& db)
+  {
+    return db(::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name, ::test::tabDepartment.division)
+                  .from(::test::tabDepartment)
+                  .where(::test::tabDepartment.id > 0)
+                  .order_by(::test::tabDepartment.id.asc()));
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 1000) "
+       "INSERT INTO tab_department (name) SELECT CASE WHEN i % 10 = 0 THEN NULL ELSE 'name_' || i END FROM n");
+
+    // The snapshot outlives the result
+    auto rows = ::sqlpp::snapshot(select_all(db));
+    expect(rows.size() == 1000, "expected all rows");
+    expect(rows[0].name == std::string_view("name_1"), "unexpected first name");
+    expect(not rows[9].name, "expected a null name");
+    expect(rows[999].id == 1000 and rows[999].division == std::string_view("engineering"), "unexpected last row");
+    // One allocation per chunk, not per string
+    expect(rows.arena().chunk_count() < 6, "expected strings to share arena chunks");
+
+    auto moved = std::move(rows);
+    expect(moved[998].name == std::string_view("name_999"), "expected strings to survive moving the snapshot");
+
+    // Appending to the moved-from snapshot must not write into the chunks of the target
+    rows.push_back(moved[1]);
+    moved.push_back(moved[2]);
+    expect(rows.size() == 1 and rows[0].name == std::string_view("name_2"), "unexpected row in moved-from snapshot");
+    expect(moved[1000].name == std::string_view("name_3"), "unexpected row appended to the target");
+    {
+      auto arena = ::sqlpp::detail::string_arena_t{};
+      const auto kept = arena.copy("kept");
+      auto target = ::sqlpp::detail::string_arena_t{};
+      target = std::move(arena);
+      expect(arena.chunk_count() == 0 and arena.allocated() == 0, "expected the moved-from arena to be empty");
+      const auto appended = arena.copy("appended");
+      const auto other = target.copy("other");
+      expect(kept == std::string_view("kept") and appended == std::string_view("appended") and
+                 other == std::string_view("other"),
+             "expected the arenas not to share memory after moving");
+    }
+
+    // Batches
+    auto result = select_all(db);
+    auto first = ::sqlpp::snapshot(result, 300);
+    auto second = ::sqlpp::snapshot(result, 300);
+    auto rest = ::sqlpp::snapshot(result);
+    expect(first.size() == 300 and second.size() == 300 and rest.size() == 400, "unexpected batch sizes");
+    expect(first[299].id == 300 and not first[299].name, "unexpected end of first batch");
+    expect(second[0].id == 301 and second[0].name == std::string_view("name_301"), "unexpected second batch");
+    expect(::sqlpp::snapshot(result).empty(), "expected the result to be exhausted");
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/sharded_connections.h>
+
+#include <sqlpp17/sqlite3/connection_pool.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using sharded_connections =
+      ::sqlpp::sharded_connections<::sqlpp::sqlite3::connector_t<::sqlpp::debug::allowed>, std::string>;
+
+  using ::sqlpp::test::expect;
+
+  const auto select_departments =
+      sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name).from(::test::tabDepartment).unconditionally();
+}  // namespace
+
+int main()
+{
+  try
+  {
+    auto shard_configs = std::vector<::sqlpp::sqlite3::connection_config_t>{};
+    for (auto shard = 0; shard < 3; ++shard)
+    {
+      auto config = ::sqlpp::sqlite3::test::get_config();
+      config.path_to_database = "sqlpp17_test_shard_" + std::to_string(shard);
+      config.debug = {};
+      shard_configs.push_back(config);
+
+      // ids 0, 3, 6, ... in shard 0, ids 1, 4, 7, ... in shard 1, ...
+      auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+      db("DROP TABLE IF EXISTS tab_department");
+      db("CREATE TABLE tab_department (id INTEGER PRIMARY KEY, name TEXT, "
+         "division TEXT NOT NULL DEFAULT 'engineering')");
+      for (auto id = shard; id < 30; id += 3)
+      {
+        db("INSERT INTO tab_department (id, name) VALUES (" + std::to_string(id) + ", 'tenant " +
+           std::to_string(shard) + "')");
+      }
+    }
+
+    auto shards = sharded_connections{{}, shard_configs, [](const std::string& tenant) {
+                                        return static_cast<std::size_t>(tenant.back() - '0');
+                                      }};
+    expect(shards.shard_count() == 3, "expected three shards");
+
+    // Single shard by key
+    {
+      auto count = 0;
+      for (const auto& row : shards("tenant 1", select_departments))
+      {
+        expect(row.id % 3 == 1, "expected rows of shard 1");
+        expect(row.name == std::string_view{"tenant 1"}, "unexpected name");
+        ++count;
+      }
+      expect(count == 10, "expected ten rows in shard 1");
+    }
+
+    // Scatter, concatenated
+    {
+      auto ids = std::vector<std::int64_t>{};
+      for (const auto& row : shards.scatter(select_departments))
+      {
+        ids.push_back(row.id);
+      }
+      expect(ids.size() == 30, "expected all rows");
+      expect(ids.front() == 0 and ids.back() == 29 and ids[10] == 1, "expected shards to be concatenated");
+    }
+
+    // Scatter, k-way merge by id
+    {
+      auto ids = std::vector<std::int64_t>{};
+      for (const auto& row : shards.scatter(select_departments, ::sqlpp::merge_ascending(::test::tabDepartment.id)))
+      {
+        ids.push_back(row.id);
+      }
+      expect(ids.size() == 30, "expected all rows");
+      for (auto i = 0; i < 30; ++i)
+      {
+        expect(ids[i] == i, "expected rows to be merged by id");
+      }
+    }
+
+    // Errors are reported after all shards are done
+    {
+      auto db = shards.get("tenant 2");
+      db("DROP TABLE tab_department");
+    }
+    try
+    {
+      for ([[maybe_unused]] const auto& row : shards.scatter(select_departments))
+      {
+      }
+      throw std::logic_error("expected scatter to fail");
+    }
+    catch (const ::sqlpp::exception&)
+    {
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
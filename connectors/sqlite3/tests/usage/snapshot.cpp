@@ -0,0 +1,218 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  const auto snapshot_path = std::string{"sqlpp17_snapshot_test"};
+  const auto copy_path = std::string{"sqlpp17_snapshot_copy_test"};
+
+  auto make_memory_connection()
+  {
+    auto config = ::sqlpp::sqlite3::connection_config_t{};
+    config.path_to_database = ":memory:";
+    config.flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    return ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+  }
+
+  auto make_file_connection(const std::string& path)
+  {
+    auto config = ::sqlpp::sqlite3::connection_config_t{};
+    config.path_to_database = path;
+    config.flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+    return ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+  }
+
+  template <typename Connection>
+  auto count_departments(Connection& db)
+  {
+    auto count = 0;
+    for ([[maybe_unused]] const auto& row : db(sqlpp::select(test::tabDepartment.id).from(test::tabDepartment).unconditionally()))
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  using ::sqlpp::test::expect;
+}  // namespace
+
+int main()
+{
+  try
+  {
+    std::remove(snapshot_path.c_str());
+    std::remove(copy_path.c_str());
+    {
+      auto db = make_file_connection(snapshot_path);
+      ::sqlpp::sqlite3::test::create_tab_department(db);
+      for (auto i = 0; i < 500; ++i)
+      {
+        db("INSERT INTO tab_department (name) VALUES ('department " + std::to_string(i) +
+           " with a name that is long enough to fill a few pages')");
+      }
+    }
+
+    // Load a file into memory using the backup API in small steps
+    {
+      auto db = make_memory_connection();
+      auto steps = 0;
+      auto last_done = 0;
+      auto last_total = 0;
+      auto options = ::sqlpp::sqlite3::backup_options_t{};
+      options.pages_per_step = 2;
+      options.progress = [&](int done, int total) {
+        ++steps;
+        last_done = done;
+        last_total = total;
+      };
+      db.load_from_file(snapshot_path, options);
+
+      expect(count_departments(db) == 500, "unexpected row count after load_from_file");
+      expect(steps > 1, "expected more than one backup step");
+      expect(last_total > 0 and last_done == last_total, "expected progress to reach the page count");
+
+      // Modify the in-memory copy and save it to disk
+      db("DELETE FROM tab_department WHERE id > 100");
+      db.save_to_file(copy_path);
+    }
+
+    // A locked source makes the backup give up after busy_timeout, without reporting progress
+    {
+      auto locker = make_file_connection(snapshot_path);
+      locker("BEGIN EXCLUSIVE");
+      auto db = make_memory_connection();
+      auto steps = 0;
+      auto options = ::sqlpp::sqlite3::backup_options_t{};
+      options.busy_timeout = std::chrono::milliseconds{50};
+      options.progress = [&steps](int, int) { ++steps; };
+      const auto start = std::chrono::steady_clock::now();
+      auto failed = false;
+      try
+      {
+        db.load_from_file(snapshot_path, options);
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      locker("COMMIT");
+      expect(failed, "expected the backup to give up");
+      expect(std::chrono::steady_clock::now() - start < std::chrono::seconds{2}, "expected busy_timeout to apply");
+      expect(steps == 0, "expected no progress for failed steps");
+    }
+
+    {
+      auto db = make_file_connection(copy_path);
+      expect(count_departments(db) == 100, "unexpected row count in saved snapshot");
+    }
+
+    // The original file is unchanged
+    {
+      auto db = make_file_connection(snapshot_path);
+      expect(count_departments(db) == 500, "snapshot source was modified");
+    }
+
+    // Load a file into memory via deserialize
+    {
+      auto db = make_memory_connection();
+      auto last_done = std::size_t{};
+      auto last_total = std::size_t{};
+      auto options = ::sqlpp::sqlite3::deserialize_options_t{};
+      options.bytes_per_step = 4096;
+      options.progress = [&](std::size_t done, std::size_t total) {
+        last_done = done;
+        last_total = total;
+      };
+      db.deserialize_file(snapshot_path, options);
+
+      expect(count_departments(db) == 500, "unexpected row count after deserialize_file");
+      expect(last_total > 0 and last_done == last_total, "expected progress to reach the file size");
+
+      // The in-memory database is writable and can grow
+      for (auto i = 0; i < 100; ++i)
+      {
+        db("INSERT INTO tab_department (name) VALUES ('another department with a long enough name')");
+      }
+      expect(count_departments(db) == 600, "unexpected row count after growing deserialized database");
+    }
+
+    // Read-only deserialization rejects writes
+    {
+      auto db = make_memory_connection();
+      auto options = ::sqlpp::sqlite3::deserialize_options_t{};
+      options.read_only = true;
+      db.deserialize_file(snapshot_path, options);
+      expect(count_departments(db) == 500, "unexpected row count after read-only deserialize_file");
+
+      auto rejected = false;
+      try
+      {
+        db("DELETE FROM tab_department");
+      }
+      catch (const sqlpp::exception&)
+      {
+        rejected = true;
+      }
+      expect(rejected, "expected write to read-only snapshot to fail");
+    }
+
+    // Missing files are reported
+    {
+      auto db = make_memory_connection();
+      auto failed = false;
+      try
+      {
+        db.deserialize_file("sqlpp17_snapshot_does_not_exist");
+      }
+      catch (const sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed, "expected deserialize_file to fail for a missing file");
+    }
+
+    std::remove(snapshot_path.c_str());
+    std::remove(copy_path.c_str());
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,130 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <iostream>
+#include <string>
+
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/spilled_result.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  auto select_departments()
+  {
+    return ::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name, ::test::tabDepartment.division)
+        .from(::test::tabDepartment)
+        .where(::test::tabDepartment.id > 0)
+        .order_by(::test::tabDepartment.id.asc());
+  }
+
+  template <typename Db, typename Row>
+  auto expect_same_rows(Db& db, const ::sqlpp::spilled_result_t<Row>& spilled) -> void
+  {
+    auto result = db(select_departments());
+    const auto expected = result.fetch_all();
+    expect(spilled.size() == expected.size(), "unexpected row count");
+    auto rows = ::sqlpp::as_result(spilled);
+    expect(rows.size_hint() == std::optional<std::size_t>{expected.size()}, "expected the row count as size hint");
+    std::size_t i = 0;
+    for (const auto& row : rows)
+    {
+      expect(i < expected.size(), "too many rows");
+      expect(row.id == expected[i].id and row.name == expected[i].name and row.division == expected[i].division,
+             "spilled rows differ");
+      ++i;
+    }
+    expect(i == expected.size(), "too few rows");
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 2000) "
+       "INSERT INTO tab_department (name, division) "
+       "SELECT CASE WHEN i % 3 = 0 THEN NULL ELSE 'name_' || i END, 'division_' || (i % 7) FROM n");
+    // A row larger than a read block
+    db("UPDATE tab_department SET name = replace(hex(zeroblob(5000)), '00', 'xy') WHERE id = 1500");
+
+    // Everything fits into memory
+    {
+      const auto spilled = ::sqlpp::materialize(db(select_departments()));
+      expect(not spilled.is_spilled() and spilled.spilled_bytes() == 0, "expected no spill file");
+      expect(spilled.size() == 2000, "expected 2000 rows");
+      expect_same_rows(db, spilled);
+    }
+
+    // Most rows go to disk and are read back in small blocks
+    {
+      auto spill_config = ::sqlpp::spill_config_t{};
+      spill_config.memory_limit = 4096;
+      spill_config.block_size = 256;
+      const auto spilled = ::sqlpp::materialize(db(select_departments()), spill_config);
+      expect(spilled.is_spilled(), "expected a spill file");
+      expect(spilled.memory().size() <= 4096, "expected the memory limit to be respected");
+      expect(spilled.spilled_bytes() > 10000, "expected most rows on disk");
+      expect(spilled.size() == 2000, "expected 2000 rows");
+      expect_same_rows(db, spilled);
+      // Reading does not consume the rows
+      expect_same_rows(db, spilled);
+
+      // Partial reads
+      auto rows = ::sqlpp::as_result(spilled);
+      const auto first = rows.fetch(1600);
+      expect(first.size() == 1600 and first[1499].name and first[1499].name->size() == 10000,
+             "expected the large row");
+      expect(rows.size_hint() == std::optional<std::size_t>{400}, "expected 400 remaining rows");
+    }
+
+    // Empty results
+    db("DELETE FROM tab_department");
+    {
+      const auto spilled = ::sqlpp::materialize(db(select_departments()));
+      expect(spilled.empty(), "expected no rows");
+      expect(::sqlpp::as_result(spilled).empty(), "expected an empty result");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
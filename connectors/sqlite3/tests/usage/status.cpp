@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <sqlpp17/clause/delete_from.h>
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  template <typename PreparedStatement>
+  auto run(PreparedStatement& statement)
+  {
+    auto count = 0;
+    for ([[maybe_unused]] const auto& row : statement.execute())
+    {
+      ++count;
+    }
+    return count;
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    for (auto i = 0; i < 200; ++i)
+    {
+      db("INSERT INTO tab_department (name) VALUES ('department " + std::to_string(i) + "')");
+    }
+
+    db.reset_status();
+    auto select_by_name = db.prepare(sqlpp::select(::test::tabDepartment.id)
+                                         .from(::test::tabDepartment)
+                                         .where(::test::tabDepartment.name == "department 7"));
+    expect(run(select_by_name) == 1, "unexpected row count");
+
+    // Without an index on name, the whole table is scanned
+    const auto scanned = select_by_name.status();
+    expect(scanned.fullscan_steps >= 199, "expected a full table scan");
+    expect(scanned.runs == 1, "expected one run");
+    expect(scanned.vm_steps > 0, "expected vm steps");
+    expect(scanned.memory_used > 0, "expected memory to be used");
+
+    // Resetting the counters
+    expect(select_by_name.reset_status().runs == 1, "expected one run before reset");
+    expect(select_by_name.status().runs == 0, "expected no runs after reset");
+
+    // With an index, the statement is reprepared and no longer scans
+    db("CREATE INDEX tab_department_name ON tab_department (name)");
+    expect(run(select_by_name) == 1, "unexpected row count with index");
+    const auto indexed = select_by_name.status();
+    expect(indexed.fullscan_steps == 0, "expected no full table scan with index");
+    expect(indexed.reprepares == 1, "expected the statement to be reprepared");
+
+    const auto database_status = db.status();
+    expect(database_status.cache_hits > 0, "expected page cache hits");
+    expect(database_status.schema_used > 0, "expected memory to be used for the schema");
+    expect(database_status.statements_used > 0, "expected memory to be used for statements");
+
+    // Report per statement type
+    auto delete_by_name = db.prepare(sqlpp::delete_from(::test::tabDepartment)
+                                         .where(::test::tabDepartment.division == "sales"));
+    delete_by_name.execute();
+
+    auto report = ::sqlpp::sqlite3::statement_status_report_t{};
+    report.add(select_by_name);
+    report.add(delete_by_name);
+    expect(report.totals().size() == 2, "expected two statement types");
+    expect(report.totals().at("select").runs == 1, "expected one select run");
+    expect(report.totals().at("delete").fullscan_steps >= 199, "expected delete to scan");
+    expect(select_by_name.status().runs == 0, "expected report to reset counters");
+
+    // One line per statement type, in name order
+    auto report_os = std::ostringstream{};
+    report.dump(report_os);
+    const auto report_text = report_os.str();
+    const auto select_line = report_text.find("\nselect: ");
+    expect(report_text.rfind("delete: fullscan_steps=", 0) == 0, "expected the delete line first");
+    expect(select_line != std::string::npos, "expected a select line");
+    expect(report_text.find("fullscan_steps=0 ", select_line) == select_line + 9, "expected select without scans");
+    expect(report_text.find(" runs=1 ", select_line) != std::string::npos, "expected one select run in the report");
+    expect(std::count(report_text.begin(), report_text.end(), '\n') == 2, "expected one line per statement type");
+
+    auto database_os = std::ostringstream{};
+    database_os << db.status();
+    const auto database_text = database_os.str();
+    expect(database_text.rfind("cache_hits=", 0) == 0, "expected the cache hits first");
+    for (const auto* field : {" cache_misses=", " lookaside_used=", " schema_used=", " statements_used="})
+    {
+      expect(database_text.find(field) != std::string::npos, std::string("expected ") + field);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
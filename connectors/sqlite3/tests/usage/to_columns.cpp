@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/result_columns.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+#include <sqlpp17/sqlite3_test/tab_department.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+#include <sqlpp17_test/tables/TabFloat.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+    ::sqlpp::sqlite3::test::create_tab_department(db);
+    db("INSERT INTO tab_department (name, division) VALUES ('first', 'sales'), (NULL, 'r&d'), ('', 'ops')");
+
+    {
+      auto columns = ::sqlpp::to_columns(db(::sqlpp::select(::test::tabDepartment.id, ::test::tabDepartment.name,
+                                                            ::test::tabDepartment.division)
+                                                .from(::test::tabDepartment)
+                                                .where(::test::tabDepartment.id > 0)
+                                                .order_by(::test::tabDepartment.id.asc())));
+      static_assert(std::is_same_v<decltype(columns.id.values), std::vector<std::int64_t>>);
+      static_assert(std::is_same_v<decltype(columns.name.values), ::sqlpp::string_column_t>);
+      expect(columns.size() == 3, "expected three rows");
+      expect(columns.id.values == std::vector<std::int64_t>{1, 2, 3}, "unexpected ids");
+
+      expect(columns.name.nulls.null_count() == 1, "expected one null name");
+      expect(not columns.name.is_null(0) and columns.name.values[0] == std::string_view("first"),
+             "unexpected first name");
+      expect(columns.name.is_null(1) and columns.name.values[1].empty(), "expected the second name to be null");
+      expect(not columns.name.is_null(2) and columns.name.values[2].empty(), "expected the third name to be empty");
+
+      expect(columns.division.values.data() == "salesr&dops", "expected the divisions in one buffer");
+      expect(columns.division.values.offsets() == std::vector<std::size_t>{0, 5, 8, 11}, "unexpected offsets");
+      expect(columns.division.values[1] == std::string_view("r&d"), "unexpected division");
+    }
+
+    db("DROP TABLE IF EXISTS tab_float");
+    db("CREATE TABLE tab_float (id INTEGER PRIMARY KEY AUTOINCREMENT, value_float REAL NOT NULL, "
+       "value_double REAL NOT NULL, value_int INTEGER NOT NULL)");
+    db("INSERT INTO tab_float (value_float, value_double, value_int) VALUES (1.5, 2.5, 1), (3.5, 4.5, 2)");
+    {
+      auto result = db(::sqlpp::select(::test::tabFloat.valueDouble, ::test::tabFloat.valueInt)
+                           .from(::test::tabFloat)
+                           .where(::test::tabFloat.id > 0)
+                           .order_by(::test::tabFloat.id.asc()));
+      auto columns = ::sqlpp::to_columns(result);
+      auto sum = 0.0;
+      for (const auto value : columns.valueDouble.values)
+      {
+        sum += value;
+      }
+      expect(sum == 7.0, "unexpected sum");
+      expect(columns.valueInt.values == std::vector<std::int32_t>{1, 2}, "unexpected ints");
+      expect(::sqlpp::to_columns(result).empty(), "expected the result to be exhausted");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sqlpp17/clause/select.h>
+
+#include <sqlpp17/sqlite3/connection.h>
+#include <sqlpp17/sqlite3/virtual_table.h>
+#include <sqlpp17/sqlite3_test/get_config.h>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+#include <sqlpp17_test/tables/TabPerson.h>
+
+namespace
+{
+  struct department
+  {
+    std::int64_t id;
+    std::optional<std::string> name;
+    std::string division;
+  };
+
+  template <typename Result>
+  auto count_rows(Result&& result)
+  {
+    auto count = 0;
+    for ([[maybe_unused]] const auto& row : result)
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  using ::sqlpp::test::expect;
+}  // namespace
+
+int main()
+{
+  try
+  {
+    const auto config = ::sqlpp::sqlite3::test::get_config();
+    auto db = ::sqlpp::sqlite3::connection_t<::sqlpp::debug::allowed>{config};
+
+    db("DROP TABLE IF EXISTS tab_person");
+    db("CREATE TABLE tab_person (id INTEGER PRIMARY KEY AUTOINCREMENT, is_manager INTEGER NOT NULL, "
+       "name TEXT NOT NULL, address TEXT, language TEXT NOT NULL DEFAULT 'C++')");
+    db("INSERT INTO tab_person (is_manager, name) VALUES (1, 'Anna'), (0, 'Bert'), (0, 'Cleo')");
+
+    auto departments = std::vector<department>{
+        {1, "Research", "engineering"}, {2, std::nullopt, "sales"}, {3, "Support", "engineering"}};
+
+    ::sqlpp::sqlite3::create_virtual_table(db, ::test::tabDepartment, departments);
+
+    // equality constraint on a text column
+    expect(count_rows(db(select(::test::tabDepartment.id)
+                             .from(::test::tabDepartment)
+                             .where(::test::tabDepartment.division == "engineering"))) == 2,
+           "equality constraint");
+
+    // range constraints on an integer column, including NULL values
+    auto in_range = 0;
+    for (const auto& row : db(select(::test::tabDepartment.id, ::test::tabDepartment.name)
+                                  .from(::test::tabDepartment)
+                                  .where(::test::tabDepartment.id >= 2 and ::test::tabDepartment.id < 3)))
+    {
+      expect(row.id == 2 and not row.name, "range constraint");
+      ++in_range;
+    }
+    expect(in_range == 1, "range constraint row count");
+
+    // join the in-memory data against an on-disk table
+    auto joined = 0;
+    for (const auto& row :
+         db(select(::test::tabPerson.name, ::test::tabDepartment.division)
+                .from(::test::tabPerson.join(::test::tabDepartment).on(::test::tabPerson.id == ::test::tabDepartment.id))
+                .where(::test::tabPerson.isManager == false)))
+    {
+      expect((row.name == std::string_view("Bert") and row.division == std::string_view("sales")) or
+                 (row.name == std::string_view("Cleo") and row.division == std::string_view("engineering")),
+             "joined row");
+      ++joined;
+    }
+    expect(joined == 2, "join");
+
+    // the range is not copied
+    departments.push_back({4, "Marketing", "sales"});
+    expect(count_rows(db(select(::test::tabDepartment.id)
+                             .from(::test::tabDepartment)
+                             .where(::test::tabDepartment.division == "sales"))) == 2,
+           "reading the current range");
+
+    ::sqlpp::sqlite3::drop_virtual_table(db, ::test::tabDepartment);
+    ::sqlpp::sqlite3::create_virtual_table(db, ::test::tabDepartment, departments);
+    ::sqlpp::sqlite3::drop_virtual_table(db, ::test::tabDepartment);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
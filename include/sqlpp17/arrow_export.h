@@ -0,0 +1,416 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <sqlpp17/exception.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_row.h>
+#include <sqlpp17/type_traits.h>
+
+// Arrow C Data Interface, see https://arrow.apache.org/docs/format/CDataInterface.html
+// The structs are part of the ABI, the guard is the one used by all implementations.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C"
+{
+  struct ArrowSchema
+  {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+  };
+
+  struct ArrowArray
+  {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+  };
+}
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace sqlpp::arrow::detail
+{
+  template <typename Structs>
+  auto release_all(Structs& structs) -> void
+  {
+    for (auto& s : structs)
+    {
+      if (s.release)
+      {
+        s.release(&s);
+      }
+    }
+  }
+
+  struct schema_data_t
+  {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> child_pointers;
+  };
+
+  inline auto release_schema(ArrowSchema* schema) -> void
+  {
+    auto* data = static_cast<schema_data_t*>(schema->private_data);
+    release_all(data->children);
+    delete data;
+    schema->release = nullptr;
+  }
+
+  inline auto make_schema(std::unique_ptr<schema_data_t> data, std::int64_t flags, ArrowSchema* out) -> void
+  {
+    for (auto& child : data->children)
+    {
+      data->child_pointers.push_back(&child);
+    }
+    out->format = data->format.c_str();
+    out->name = data->name.c_str();
+    out->metadata = nullptr;
+    out->flags = flags;
+    out->n_children = static_cast<std::int64_t>(data->children.size());
+    out->children = data->child_pointers.empty() ? nullptr : data->child_pointers.data();
+    out->dictionary = nullptr;
+    out->release = &release_schema;
+    out->private_data = data.release();
+  }
+
+  // Owns the buffers of one array. Buffers that are not used by an array's layout stay empty.
+  struct array_data_t
+  {
+    std::vector<std::uint8_t> validity;
+    std::vector<std::uint8_t> values;
+    std::vector<std::int32_t> offsets;
+    std::string data;
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> child_pointers;
+  };
+
+  inline auto release_array(ArrowArray* array) -> void
+  {
+    auto* data = static_cast<array_data_t*>(array->private_data);
+    release_all(data->children);
+    delete data;
+    array->release = nullptr;
+  }
+
+  inline auto make_array(std::unique_ptr<array_data_t> data,
+                         std::int64_t length,
+                         std::int64_t null_count,
+                         ArrowArray* out) -> void
+  {
+    for (auto& child : data->children)
+    {
+      data->child_pointers.push_back(&child);
+    }
+    out->length = length;
+    out->null_count = null_count;
+    out->offset = 0;
+    out->n_buffers = static_cast<std::int64_t>(data->buffers.size());
+    out->n_children = static_cast<std::int64_t>(data->children.size());
+    out->buffers = data->buffers.data();
+    out->children = data->child_pointers.empty() ? nullptr : data->child_pointers.data();
+    out->dictionary = nullptr;
+    out->release = &release_array;
+    out->private_data = data.release();
+  }
+
+  // Bitmaps are LSB first
+  inline auto append_bit(std::vector<std::uint8_t>& bits, std::size_t index, bool value) -> void
+  {
+    if (index % 8 == 0)
+    {
+      bits.push_back(0);
+    }
+    if (value)
+    {
+      bits.back() |= static_cast<std::uint8_t>(1u << (index % 8));
+    }
+  }
+
+  template <typename T>
+  constexpr auto format_of() -> const char*
+  {
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      return "b";
+    }
+    else if constexpr (std::is_same_v<T, std::string_view>)
+    {
+      return "u";
+    }
+    else if constexpr (std::is_same_v<T, float>)
+    {
+      return "f";
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+      return "g";
+    }
+    else if constexpr (std::is_integral_v<T> and sizeof(T) == 1)
+    {
+      return std::is_signed_v<T> ? "c" : "C";
+    }
+    else if constexpr (std::is_integral_v<T> and sizeof(T) == 2)
+    {
+      return std::is_signed_v<T> ? "s" : "S";
+    }
+    else if constexpr (std::is_integral_v<T> and sizeof(T) == 4)
+    {
+      return std::is_signed_v<T> ? "i" : "I";
+    }
+    else if constexpr (std::is_integral_v<T> and sizeof(T) == 8)
+    {
+      return std::is_signed_v<T> ? "l" : "L";
+    }
+    else
+    {
+      static_assert(wrong<T>, "No Arrow type for this result value type");
+    }
+  }
+
+  template <typename ColumnSpec>
+  using arrow_value_t = remove_optional_t<result_column_value_t<ColumnSpec>>;
+
+  template <typename ColumnSpec>
+  auto make_column_schema(ArrowSchema* out) -> void
+  {
+    auto data = std::make_unique<schema_data_t>();
+    data->format = format_of<arrow_value_t<ColumnSpec>>();
+    data->name = std::string(name_tag_of_t<ColumnSpec>::name);
+    make_schema(std::move(data), ColumnSpec::can_be_null ? ARROW_FLAG_NULLABLE : 0, out);
+  }
+
+  template <typename ColumnSpec>
+  class column_builder_t
+  {
+    using _value_t = arrow_value_t<ColumnSpec>;
+
+    std::unique_ptr<array_data_t> _data = std::make_unique<array_data_t>();
+    std::size_t _length = 0;
+    std::size_t _null_count = 0;
+
+    auto append_value(const _value_t& value) -> void
+    {
+      if constexpr (std::is_same_v<_value_t, bool>)
+      {
+        append_bit(_data->values, _length, value);
+      }
+      else if constexpr (std::is_same_v<_value_t, std::string_view>)
+      {
+        _data->data.append(value);
+        if (_data->data.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+        {
+          throw ::sqlpp::exception("Arrow export: Text column exceeds 2 GiB in one batch, use smaller batches");
+        }
+        _data->offsets.push_back(static_cast<std::int32_t>(_data->data.size()));
+      }
+      else
+      {
+        const auto position = _data->values.size();
+        _data->values.resize(position + sizeof(_value_t));
+        std::memcpy(_data->values.data() + position, &value, sizeof(_value_t));
+      }
+    }
+
+  public:
+    column_builder_t()
+    {
+      if constexpr (std::is_same_v<_value_t, std::string_view>)
+      {
+        _data->offsets.push_back(0);
+      }
+    }
+
+    auto append(const result_column_value_t<ColumnSpec>& value) -> void
+    {
+      if constexpr (ColumnSpec::can_be_null)
+      {
+        append_bit(_data->validity, _length, value.has_value());
+        if (value)
+        {
+          append_value(*value);
+        }
+        else
+        {
+          ++_null_count;
+          append_value(_value_t{});
+        }
+      }
+      else
+      {
+        append_value(value);
+      }
+      ++_length;
+    }
+
+    auto finish(ArrowArray* out) -> void
+    {
+      // Without nulls, the validity bitmap may be omitted
+      const void* validity = _null_count ? _data->validity.data() : nullptr;
+      if constexpr (std::is_same_v<_value_t, std::string_view>)
+      {
+        _data->buffers = {validity, _data->offsets.data(), _data->data.data()};
+      }
+      else
+      {
+        _data->buffers = {validity, _data->values.data()};
+      }
+      make_array(std::move(_data), static_cast<std::int64_t>(_length), static_cast<std::int64_t>(_null_count), out);
+    }
+  };
+
+  template <typename Row>
+  struct batch_builder_t
+  {
+    static_assert(wrong<Row>, "Row must be a result_row_t<...>");
+  };
+
+  // Builds a struct array with one child per column
+  template <typename... ColumnSpecs>
+  class batch_builder_t<result_row_t<ColumnSpecs...>>
+  {
+    std::tuple<column_builder_t<ColumnSpecs>...> _columns;
+    std::size_t _length = 0;
+
+  public:
+    static auto export_schema(ArrowSchema* out) -> void
+    {
+      auto data = std::make_unique<schema_data_t>();
+      data->format = "+s";
+      data->children.resize(sizeof...(ColumnSpecs));
+      auto* child = data->children.data();
+      try
+      {
+        (..., make_column_schema<ColumnSpecs>(child++));
+      }
+      catch (...)
+      {
+        release_all(data->children);
+        throw;
+      }
+      make_schema(std::move(data), 0, out);
+    }
+
+    auto append(const result_row_t<ColumnSpecs...>& row) -> void
+    {
+      (..., std::get<column_builder_t<ColumnSpecs>>(_columns).append(
+                static_cast<const result_column_base<ColumnSpecs>&>(row)()));
+      ++_length;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _length;
+    }
+
+    auto finish(ArrowArray* out) -> void
+    {
+      auto data = std::make_unique<array_data_t>();
+      data->buffers = {nullptr};
+      data->children.resize(sizeof...(ColumnSpecs));
+      auto* child = data->children.data();
+      try
+      {
+        (..., std::get<column_builder_t<ColumnSpecs>>(_columns).finish(child++));
+      }
+      catch (...)
+      {
+        release_all(data->children);
+        throw;
+      }
+      make_array(std::move(data), static_cast<std::int64_t>(_length), 0, out);
+    }
+  };
+}  // namespace sqlpp::arrow::detail
+
+namespace sqlpp::arrow
+{
+  // Schema of the rows of a result: a struct with one child per selected column, derived from the column specs.
+  // The caller owns the schema and has to call its release callback.
+  template <typename Row>
+  auto export_schema(ArrowSchema* out) -> void
+  {
+    detail::batch_builder_t<Row>::export_schema(out);
+  }
+
+  template <typename ResultHandle>
+  auto export_schema(const result_t<ResultHandle>&, ArrowSchema* out) -> void
+  {
+    export_schema<typename result_t<ResultHandle>::_row_t>(out);
+  }
+
+  // Moves up to n of the remaining rows into a struct array (a record batch) and returns the number of rows.
+  // The caller owns the array and has to call its release callback, also for empty batches.
+  template <typename ResultHandle>
+  auto export_batch(result_t<ResultHandle>& result, std::size_t n, ArrowArray* out) -> std::size_t
+  {
+    auto builder = detail::batch_builder_t<typename result_t<ResultHandle>::_row_t>{};
+    while (builder.size() < n and result._handle)
+    {
+      result._handle.get_next_row();
+      if (not result._handle)
+      {
+        break;
+      }
+      builder.append(result._handle.row());
+    }
+    builder.finish(out);
+    return builder.size();
+  }
+}  // namespace sqlpp::arrow
@@ -49,6 +49,8 @@ namespace sqlpp
   struct pool_base
   {
     Pool* _connection_pool = nullptr;
+    // Set by the pool, handed back with the handle
+    typename Pool::entry_type* _pool_entry = nullptr;
 
     pool_base() = default;
 
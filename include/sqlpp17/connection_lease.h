@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sqlpp
+{
+  // Borrows a connection from Pool for the current thread. Nested leases for the same pool in the same thread share
+  // the connection (and thereby its prepared statements and its transaction). The connection is returned to the pool
+  // when the outermost lease is destroyed.
+  // Leases are bound to the thread that created them. Code that may continue on another thread (e.g. a coroutine)
+  // has to pass the lease or its connection along explicitly.
+  template <typename Pool>
+  class connection_lease_t
+  {
+  public:
+    using connection_type = typename Pool::connection_type;
+
+  private:
+    struct slot_t
+    {
+      Pool* pool;
+      std::unique_ptr<connection_type> connection;
+      std::size_t depth;
+    };
+
+    static auto slots() -> std::vector<slot_t>&
+    {
+      static thread_local auto thread_slots = std::vector<slot_t>{};
+      return thread_slots;
+    }
+
+    static auto find_slot(Pool& pool) -> slot_t*
+    {
+      for (auto& slot : slots())
+      {
+        if (slot.pool == &pool)
+          return &slot;
+      }
+      return nullptr;
+    }
+
+    template <typename Acquire>
+    static auto acquire(Pool& pool, const Acquire& get) -> connection_type*
+    {
+      if (auto* slot = find_slot(pool))
+      {
+        ++slot->depth;
+        return slot->connection.get();
+      }
+
+      auto connection = std::make_unique<connection_type>(get());
+      auto* result = connection.get();
+      slots().push_back(slot_t{&pool, std::move(connection), 1});
+      return result;
+    }
+
+    Pool& _pool;
+    connection_type* _connection;
+
+  public:
+    explicit connection_lease_t(Pool& pool) : _pool(pool), _connection(acquire(pool, [&pool]() { return pool.get(); }))
+    {
+    }
+
+    // The timeout applies only if the connection is not leased by this thread already
+    template <typename Rep, typename Period>
+    connection_lease_t(Pool& pool, std::chrono::duration<Rep, Period> timeout)
+        : _pool(pool), _connection(acquire(pool, [&pool, timeout]() { return pool.get(timeout); }))
+    {
+    }
+
+    connection_lease_t(const connection_lease_t&) = delete;
+    connection_lease_t(connection_lease_t&&) = delete;  // bound to the scope and thread that created it
+    connection_lease_t& operator=(const connection_lease_t&) = delete;
+    connection_lease_t& operator=(connection_lease_t&&) = delete;
+    ~connection_lease_t()
+    {
+      auto& thread_slots = slots();
+      auto* slot = find_slot(_pool);
+      if (slot and --slot->depth == 0)
+      {
+        // returns the connection to the pool
+        std::swap(*slot, thread_slots.back());
+        thread_slots.pop_back();
+      }
+    }
+
+    // Number of nested leases of the pool in the current thread
+    [[nodiscard]] static auto depth(Pool& pool) -> std::size_t
+    {
+      const auto* slot = find_slot(pool);
+      return slot ? slot->depth : 0;
+    }
+
+    auto& get() const
+    {
+      return *_connection;
+    }
+
+    auto& operator*() const
+    {
+      return *_connection;
+    }
+
+    auto* operator->() const
+    {
+      return _connection;
+    }
+
+    template <typename Statement>
+    auto operator()(const Statement& statement) const
+    {
+      return (*_connection)(statement);
+    }
+  };
+}  // namespace sqlpp
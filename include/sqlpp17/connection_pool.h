@@ -0,0 +1,706 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sqlpp17/connection_lease.h>
+#include <sqlpp17/connection_pool_metrics.h>
+#include <sqlpp17/exception.h>
+#include <sqlpp17/detail/idle_handles.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    template <typename Connector, typename = void>
+    constexpr auto has_connect_many_v = false;
+
+    template <typename Connector>
+    constexpr auto has_connect_many_v<
+        Connector,
+        std::void_t<decltype(Connector::connect_many(std::declval<const typename Connector::config_type&>(),
+                                                     std::size_t{},
+                                                     std::declval<std::vector<typename Connector::handle_type>&>()))>> =
+        true;
+  }  // namespace detail
+
+  struct connection_pool_config_t
+  {
+    // Connections opened when the pool is created and kept open by the reaper
+    std::size_t min_size = 0;
+    // Upper bound for connections in use and idle. Further requests wait until a connection is returned.
+    std::size_t max_size = 10;
+    // Number of threads used to open connections in prewarm()
+    std::size_t connect_parallelism = 8;
+    // Connections that have been idle for at least this long are checked with Connector::is_alive() on checkout
+    std::chrono::milliseconds validate_after_idle = std::chrono::seconds{1};
+    // Connections are replaced once they are this old, zero for no limit
+    std::chrono::milliseconds max_lifetime = {};
+    // Idle connections beyond min_size are closed by the reaper after this time, zero for no limit
+    std::chrono::milliseconds max_idle_time = std::chrono::minutes{10};
+    // Interval for the background reaper thread, zero for no reaper thread, see connection_pool::reap()
+    std::chrono::milliseconds reaper_interval = {};
+    // Called for each pool event in addition to updating the pool's counters, see connection_pool::metrics().
+    // Must be thread-safe and fast, since it is called while connections are checked out and returned.
+    std::function<void(connection_pool_event, std::chrono::steady_clock::duration)> metrics_sink = {};
+  };
+
+  // Thrown by connection_pool::get(timeout) if no connection became available in time
+  class connection_pool_timeout_exception : public ::sqlpp::exception
+  {
+    using exception::exception;
+  };
+
+  struct no_warm_up_t
+  {
+    template <typename Connection>
+    auto operator()(Connection&) const -> void
+    {
+    }
+  };
+
+  // A Connector provides
+  //   config_type, handle_type (e.g. a unique_ptr to the native connection handle),
+  //   template<typename Pool> connection_type, e.g. base_connection<Pool, Debug>,
+  //   static auto connect(const config_type&) -> handle_type,
+  //   static auto is_alive(handle_type&) -> bool, a cheap check, called before idle handles are handed out again
+  //   statement_registry_type, per physical connection, kept while idle, see statement_registry_t
+  // Optionally
+  //   static auto connect_many(const config_type&, std::size_t count, std::vector<handle_type>&) -> void, opening
+  //   connections concurrently without additional threads. Appends the opened handles, then throws on failure.
+  // Connections return their handle via _connection_pool->put(handle, _pool_entry), see pool_base.
+  template <typename Connector>
+  class connection_pool
+  {
+  public:
+    using config_type = typename Connector::config_type;
+    using handle_type = typename Connector::handle_type;
+    using connection_type = typename Connector::template connection_type<connection_pool>;
+    using statement_registry_type = typename Connector::statement_registry_type;
+    using clock = std::chrono::steady_clock;
+
+    // One per open connection, owns the handle while the connection is idle
+    struct entry_type
+    {
+      handle_type handle;
+      clock::time_point created;
+      clock::time_point idle_since;
+      clock::time_point checked_out;  // zero if not checked out via get(), e.g. in prewarm()
+      // declared after the handle, so that statements are released before the connection is closed
+      statement_registry_type statements = {};
+    };
+
+  private:
+    struct waiter_t
+    {
+      std::condition_variable ready;
+      entry_type* entry = nullptr;
+      bool may_connect = false;  // a connection slot was handed over instead of a connection
+    };
+
+    connection_pool_config_t _pool_config;
+    config_type _connection_config;
+    // Idle entries are stored and retrieved without locking the mutex, as long as nobody is waiting
+    detail::idle_handles_t<entry_type*> _idle;
+    std::atomic<std::size_t> _waiting = 0;
+    std::mutex _mutex;
+    std::deque<waiter_t*> _waiters;
+    std::size_t _size = 0;  // idle, in use, or being opened
+    connection_pool_counters_t _counters;
+    bool _stopping = false;
+    std::condition_variable _reaper_wakeup;
+    std::thread _reaper;
+
+    friend connection_type;
+
+    [[nodiscard]] auto pop_idle(bool anywhere) -> std::unique_ptr<entry_type>
+    {
+      auto* entry = static_cast<entry_type*>(nullptr);
+      if (anywhere ? _idle.try_pop_any(entry) : _idle.try_pop(entry))
+        return std::unique_ptr<entry_type>{entry};
+      return {};
+    }
+
+    [[nodiscard]] auto is_expired(const entry_type& entry, clock::time_point now) const
+    {
+      return _pool_config.max_lifetime.count() and now - entry.created >= _pool_config.max_lifetime;
+    }
+
+    auto notify(connection_pool_event event, clock::duration duration) -> void
+    {
+      _counters.record(event, duration);
+      if (_pool_config.metrics_sink)
+        _pool_config.metrics_sink(event, duration);
+    }
+
+    [[nodiscard]] auto make_entry(handle_type handle, clock::time_point connect_start) -> std::unique_ptr<entry_type>
+    {
+      const auto now = clock::now();
+      notify(connection_pool_event::connect, now - connect_start);
+      return std::make_unique<entry_type>(entry_type{std::move(handle), now, now, {}});
+    }
+
+    [[nodiscard]] auto open_entry() -> std::unique_ptr<entry_type>
+    {
+      const auto start = clock::now();
+      try
+      {
+        return make_entry(Connector::connect(_connection_config), start);
+      }
+      catch (...)
+      {
+        notify(connection_pool_event::connect_failure, clock::now() - start);
+        throw;
+      }
+    }
+
+    auto close_entry(std::unique_ptr<entry_type> entry) -> void
+    {
+      notify(connection_pool_event::close, clock::now() - entry->created);
+    }
+
+    // The slot of the entry is released if the connection cannot be constructed
+    [[nodiscard]] auto make_connection(std::unique_ptr<entry_type> entry) -> connection_type
+    {
+      try
+      {
+        auto connection = connection_type{_connection_config, std::move(entry->handle), this};
+        connection._pool_entry = entry.release();
+        return connection;
+      }
+      catch (...)
+      {
+        close_entry(std::move(entry));
+        const auto lock = std::scoped_lock{_mutex};
+        release_slot();
+        throw;
+      }
+    }
+
+    [[nodiscard]] auto acquire(std::optional<clock::time_point> deadline) -> connection_type
+    {
+      const auto start = clock::now();
+      // Fast path, unless others are already waiting
+      auto entry = _waiting.load() == 0 ? pop_idle(false) : std::unique_ptr<entry_type>{};
+
+      if (not entry)
+      {
+        auto lock = std::unique_lock{_mutex};
+        if (_waiters.empty())
+        {
+          entry = pop_idle(true);
+        }
+        if (not entry and _waiters.empty() and _size < _pool_config.max_size)
+        {
+          ++_size;
+        }
+        else if (not entry)
+        {
+          // wait in line, connections and slots are handed over in FIFO order
+          auto waiter = waiter_t{};
+          _waiters.push_back(&waiter);
+          ++_waiting;
+          // entries returned via the fast path before we were registered
+          serve_waiters();
+
+          const auto served = [&waiter]() { return waiter.entry or waiter.may_connect; };
+          if (deadline)
+          {
+            if (not waiter.ready.wait_until(lock, *deadline, served))
+            {
+              _waiters.erase(std::find(_waiters.begin(), _waiters.end(), &waiter));
+              --_waiting;
+              lock.unlock();
+              notify(connection_pool_event::timeout, clock::now() - start);
+              throw connection_pool_timeout_exception("Connection pool: No connection available within timeout");
+            }
+          }
+          else
+          {
+            waiter.ready.wait(lock, served);
+          }
+          entry.reset(waiter.entry);
+        }
+      }
+
+      // Expired and dead connections are replaced, using the same slot
+      if (entry)
+      {
+        const auto now = clock::now();
+        if (is_expired(*entry, now) or
+            (now - entry->idle_since >= _pool_config.validate_after_idle and not Connector::is_alive(entry->handle)))
+        {
+          close_entry(std::move(entry));
+        }
+      }
+
+      if (not entry)
+      {
+        try
+        {
+          entry = open_entry();
+        }
+        catch (...)
+        {
+          const auto lock = std::scoped_lock{_mutex};
+          release_slot();
+          throw;
+        }
+      }
+
+      entry->checked_out = clock::now();
+      notify(connection_pool_event::checkout, entry->checked_out - start);
+      auto connection = make_connection(std::move(entry));
+      return connection;
+    }
+
+    // Expects the mutex to be locked and waiters to be present
+    auto pop_waiter() -> waiter_t&
+    {
+      auto* waiter = _waiters.front();
+      _waiters.pop_front();
+      --_waiting;
+      return *waiter;
+    }
+
+    // Expects the mutex to be locked
+    auto serve_waiters() -> void
+    {
+      while (not _waiters.empty())
+      {
+        auto entry = pop_idle(true);
+        if (not entry)
+          return;
+        auto& waiter = pop_waiter();
+        waiter.entry = entry.release();
+        waiter.ready.notify_one();
+      }
+    }
+
+    // Expects the mutex to be locked
+    auto release_slot() -> void
+    {
+      if (_waiters.empty())
+      {
+        --_size;
+        return;
+      }
+      auto& waiter = pop_waiter();
+      waiter.may_connect = true;
+      waiter.ready.notify_one();
+    }
+
+    auto make_idle(std::unique_ptr<entry_type> entry) -> void
+    {
+      if (_waiting.load() == 0)
+      {
+        _idle.push(entry.release());
+        // pairs with the increment of _waiting in acquire(): either the waiter sees the entry, or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_waiting.load(std::memory_order_relaxed) == 0)
+          return;
+
+        const auto lock = std::scoped_lock{_mutex};
+        serve_waiters();
+        return;
+      }
+
+      const auto lock = std::scoped_lock{_mutex};
+      if (_waiters.empty())
+      {
+        _idle.push(entry.release());
+      }
+      else
+      {
+        auto& waiter = pop_waiter();
+        waiter.entry = entry.release();
+        waiter.ready.notify_one();
+      }
+    }
+
+    auto put(handle_type handle, entry_type* pool_entry) -> void
+    {
+      auto entry = std::unique_ptr<entry_type>{pool_entry};
+      const auto now = clock::now();
+      if (entry and entry->checked_out.time_since_epoch().count())
+      {
+        notify(connection_pool_event::checkin, now - entry->checked_out);
+        entry->checked_out = {};
+      }
+      if (not handle or not entry)
+      {
+        if (entry)
+          close_entry(std::move(entry));
+        const auto lock = std::scoped_lock{_mutex};
+        release_slot();
+        return;
+      }
+
+      entry->handle = std::move(handle);
+      entry->idle_since = now;
+      make_idle(std::move(entry));
+    }
+
+    auto close_idle() -> void
+    {
+      while (auto entry = pop_idle(true))
+      {
+        close_entry(std::move(entry));
+      }
+    }
+
+    auto run_reaper() -> void
+    {
+      auto lock = std::unique_lock{_mutex};
+      while (not _stopping)
+      {
+        _reaper_wakeup.wait_for(lock, _pool_config.reaper_interval, [this]() { return _stopping; });
+        if (_stopping)
+          break;
+
+        lock.unlock();
+        try
+        {
+          reap();
+        }
+        catch (...)
+        {
+          // try again next time
+        }
+        lock.lock();
+      }
+    }
+
+  public:
+    connection_pool() = delete;
+    // Opens min_size connections in parallel, see prewarm()
+    template <typename WarmUp = no_warm_up_t>
+    connection_pool(const connection_pool_config_t& pool_config,
+                    config_type connection_config,
+                    const WarmUp& warm_up = {})
+        : _pool_config(pool_config), _connection_config(std::move(connection_config)), _idle(pool_config.max_size)
+    {
+      if (_pool_config.max_size == 0)
+      {
+        throw ::sqlpp::exception("Connection pool: max_size must be greater than zero");
+      }
+      if (_pool_config.min_size > _pool_config.max_size)
+      {
+        throw ::sqlpp::exception("Connection pool: min_size must not exceed max_size");
+      }
+
+      try
+      {
+        prewarm(_pool_config.min_size, warm_up);
+      }
+      catch (...)
+      {
+        // the destructor is not called
+        close_idle();
+        throw;
+      }
+
+      if (_pool_config.reaper_interval.count())
+      {
+        _reaper = std::thread{[this]() { run_reaper(); }};
+      }
+    }
+    connection_pool(std::size_t max_size, config_type connection_config)
+        : connection_pool(connection_pool_config_t{0, max_size}, std::move(connection_config))
+    {
+    }
+    connection_pool(const connection_pool&) = delete;
+    connection_pool(connection_pool&&) = delete;
+    connection_pool& operator=(const connection_pool&) = delete;
+    connection_pool& operator=(connection_pool&&) = delete;
+    ~connection_pool()
+    {
+      if (_reaper.joinable())
+      {
+        {
+          const auto lock = std::scoped_lock{_mutex};
+          _stopping = true;
+        }
+        _reaper_wakeup.notify_one();
+        _reaper.join();
+      }
+      close_idle();
+    }
+
+    // Opens up to count additional connections (limited by max_size) using up to connect_parallelism threads, or
+    // Connector::connect_many() if available, and calls warm_up(connection_type&) for each of them, e.g. to prepare
+    // statements. Stops opening connections and rethrows after the first failure.
+    template <typename WarmUp = no_warm_up_t>
+    auto prewarm(std::size_t count, const WarmUp& warm_up = {}) -> void
+    {
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        count = std::min(count, _pool_config.max_size - _size);
+        _size += count;
+      }
+      if (count == 0)
+        return;
+
+      auto next = std::atomic<std::size_t>{0};
+      auto opened = std::atomic<std::size_t>{0};
+      auto failed = std::atomic<bool>{false};
+      auto first_error = std::exception_ptr{};
+      auto error_mutex = std::mutex{};
+
+      const auto open_connections = [&]() {
+        while (not failed and next++ < count)
+        {
+          try
+          {
+            auto connection = make_connection(open_entry());
+            ++opened;
+            warm_up(connection);
+          }
+          catch (...)
+          {
+            const auto lock = std::scoped_lock{error_mutex};
+            if (not first_error)
+              first_error = std::current_exception();
+            failed = true;
+          }
+        }
+      };
+
+      if constexpr (detail::has_connect_many_v<Connector>)
+      {
+        // the connector opens all connections concurrently from this thread
+        auto handles = std::vector<handle_type>{};
+        const auto start = clock::now();
+        try
+        {
+          Connector::connect_many(_connection_config, count, handles);
+        }
+        catch (...)
+        {
+          // the first error is rethrown, but each missing connection is a failure
+          const auto duration = clock::now() - start;
+          for (auto i = handles.size(); i < count; ++i)
+          {
+            notify(connection_pool_event::connect_failure, duration);
+          }
+          first_error = std::current_exception();
+        }
+        for (auto& handle : handles)
+        {
+          // after a failure, the remaining handles are closed without being warmed up
+          if (first_error)
+            break;
+          try
+          {
+            auto connection = make_connection(make_entry(std::move(handle), start));
+            ++opened;
+            warm_up(connection);
+          }
+          catch (...)
+          {
+            first_error = std::current_exception();
+          }
+        }
+      }
+      else
+      {
+        const auto thread_count = std::min(count, std::max<std::size_t>(_pool_config.connect_parallelism, 1));
+        auto threads = std::vector<std::thread>{};
+        for (auto i = std::size_t{1}; i < thread_count; ++i)
+        {
+          threads.emplace_back(open_connections);
+        }
+        open_connections();
+        for (auto& thread : threads)
+        {
+          thread.join();
+        }
+      }
+
+      // release the slots of connections that were not opened
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        for (auto i = opened.load(); i < count; ++i)
+        {
+          release_slot();
+        }
+      }
+
+      if (first_error)
+      {
+        std::rethrow_exception(first_error);
+      }
+    }
+
+    // Closes idle connections that are expired, dead (checked after validate_after_idle), or idle for longer than
+    // max_idle_time (as long as there are more than min_size connections) and opens connections to get back to
+    // min_size.
+    // Called periodically by the reaper thread, if configured.
+    auto reap() -> void
+    {
+      const auto now = clock::now();
+      const auto needs_validation = [this, now](const entry_type& entry) {
+        return now - entry.idle_since >= _pool_config.validate_after_idle;
+      };
+      const auto idle_too_long = [this, now](const entry_type& entry) {
+        return _pool_config.max_idle_time.count() and now - entry.idle_since >= _pool_config.max_idle_time;
+      };
+
+      // Only entries that might be closed are taken out of the pool, the others stay where they are
+      auto idle = std::vector<std::unique_ptr<entry_type>>{};
+      for (auto* entry : _idle.take_if([&](const entry_type* entry) {
+             return is_expired(*entry, now) or needs_validation(*entry) or idle_too_long(*entry);
+           }))
+      {
+        idle.emplace_back(entry);
+      }
+      // entries that were looked at and put back may have been missed by threads that started waiting meanwhile
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (_waiting.load(std::memory_order_relaxed) != 0)
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        serve_waiters();
+      }
+      // oldest idle first
+      std::sort(idle.begin(), idle.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs->idle_since < rhs->idle_since; });
+
+      auto size = this->size();
+      auto closed = std::size_t{};
+      for (auto& entry : idle)
+      {
+        if ((idle_too_long(*entry) and size - closed > _pool_config.min_size) or is_expired(*entry, now) or
+            (needs_validation(*entry) and not Connector::is_alive(entry->handle)))
+        {
+          close_entry(std::move(entry));
+          ++closed;
+        }
+      }
+
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        for (auto i = std::size_t{}; i < closed; ++i)
+        {
+          release_slot();
+        }
+      }
+      for (auto& entry : idle)
+      {
+        if (entry)
+          make_idle(std::move(entry));
+      }
+
+      size = this->size();
+      if (size < _pool_config.min_size)
+      {
+        prewarm(_pool_config.min_size - size);
+      }
+    }
+
+    // Blocks until a connection is available
+    [[nodiscard]] auto get() -> connection_type
+    {
+      return acquire(std::nullopt);
+    }
+
+    // Throws connection_pool_timeout_exception if no connection is available within timeout
+    template <typename Rep, typename Period>
+    [[nodiscard]] auto get(std::chrono::duration<Rep, Period> timeout) -> connection_type
+    {
+      return acquire(clock::now() + timeout);
+    }
+
+    // Shares the connection with other leases of this pool in the current thread, see connection_lease_t
+    [[nodiscard]] auto lease() -> connection_lease_t<connection_pool>
+    {
+      return connection_lease_t<connection_pool>{*this};
+    }
+
+    template <typename Rep, typename Period>
+    [[nodiscard]] auto lease(std::chrono::duration<Rep, Period> timeout) -> connection_lease_t<connection_pool>
+    {
+      return connection_lease_t<connection_pool>{*this, timeout};
+    }
+
+    [[nodiscard]] auto size() -> std::size_t
+    {
+      const auto lock = std::scoped_lock{_mutex};
+      return _size;
+    }
+
+    // Exact only if no connections are being returned or acquired concurrently
+    [[nodiscard]] auto idle_size() const -> std::size_t
+    {
+      return _idle.size_hint();
+    }
+
+    [[nodiscard]] auto max_size() const
+    {
+      return _pool_config.max_size;
+    }
+
+    [[nodiscard]] auto metrics() -> connection_pool_metrics_t
+    {
+      auto size = std::size_t{};
+      auto waiting = std::size_t{};
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        size = _size;
+        waiting = _waiters.size();
+      }
+      const auto idle = std::min(idle_size(), size);
+      return connection_pool_metrics_t{size,
+                                       idle,
+                                       size - idle,
+                                       waiting,
+                                       _pool_config.max_size,
+                                       _counters.checkouts.load(std::memory_order_relaxed),
+                                       _counters.timeouts.load(std::memory_order_relaxed),
+                                       _counters.connections_created.load(std::memory_order_relaxed),
+                                       _counters.connections_closed.load(std::memory_order_relaxed),
+                                       _counters.connect_failures.load(std::memory_order_relaxed),
+                                       _counters.wait_time,
+                                       _counters.checkout_duration,
+                                       _counters.connect_time};
+    }
+  };
+}  // namespace sqlpp
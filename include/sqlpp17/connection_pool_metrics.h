@@ -0,0 +1,248 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace sqlpp
+{
+  // Counts durations in buckets of powers of two microseconds: [0, 1), [1, 2), [2, 4), ...
+  // Recording is lock-free.
+  class latency_histogram_t
+  {
+  public:
+    static constexpr std::size_t bucket_count = 32;
+
+  private:
+    std::array<std::atomic<std::uint64_t>, bucket_count> _buckets = {};
+    std::atomic<std::uint64_t> _total_microseconds = 0;
+
+  public:
+    latency_histogram_t() = default;
+    // Copies are snapshots
+    latency_histogram_t(const latency_histogram_t& rhs)
+    {
+      for (auto i = std::size_t{}; i < bucket_count; ++i)
+      {
+        _buckets[i] = rhs._buckets[i].load(std::memory_order_relaxed);
+      }
+      _total_microseconds = rhs._total_microseconds.load(std::memory_order_relaxed);
+    }
+    latency_histogram_t& operator=(const latency_histogram_t&) = delete;
+    ~latency_histogram_t() = default;
+
+    [[nodiscard]] static auto bucket_of(std::chrono::microseconds duration) -> std::size_t
+    {
+      auto bucket = std::size_t{};
+      for (auto value = static_cast<std::uint64_t>(std::max(duration.count(), decltype(duration.count()){}));
+           value and bucket + 1 < bucket_count; value >>= 1)
+      {
+        ++bucket;
+      }
+      return bucket;
+    }
+
+    // Exclusive upper limit of the bucket
+    [[nodiscard]] static auto upper_bound(std::size_t bucket) -> std::chrono::microseconds
+    {
+      return std::chrono::microseconds{std::int64_t{1} << bucket};
+    }
+
+    template <typename Rep, typename Period>
+    auto record(std::chrono::duration<Rep, Period> duration) -> void
+    {
+      const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+      _buckets[bucket_of(microseconds)].fetch_add(1, std::memory_order_relaxed);
+      _total_microseconds.fetch_add(static_cast<std::uint64_t>(std::max(microseconds.count(), std::int64_t{})),
+                                    std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto bucket(std::size_t i) const -> std::uint64_t
+    {
+      return _buckets[i].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto count() const -> std::uint64_t
+    {
+      auto result = std::uint64_t{};
+      for (const auto& b : _buckets)
+      {
+        result += b.load(std::memory_order_relaxed);
+      }
+      return result;
+    }
+
+    [[nodiscard]] auto total() const -> std::chrono::microseconds
+    {
+      return std::chrono::microseconds{_total_microseconds.load(std::memory_order_relaxed)};
+    }
+
+    [[nodiscard]] auto mean() const -> std::chrono::microseconds
+    {
+      const auto n = count();
+      return n ? std::chrono::microseconds{total().count() / static_cast<std::int64_t>(n)} : std::chrono::microseconds{};
+    }
+
+    // Upper bound of the bucket containing the given percentile (0 - 100)
+    [[nodiscard]] auto percentile(double p) const -> std::chrono::microseconds
+    {
+      const auto n = count();
+      if (n == 0)
+        return {};
+      const auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(n - 1)) + 1;
+      auto seen = std::uint64_t{};
+      for (auto i = std::size_t{}; i < bucket_count; ++i)
+      {
+        seen += bucket(i);
+        if (seen >= rank)
+          return upper_bound(i);
+      }
+      return upper_bound(bucket_count - 1);
+    }
+  };
+
+  enum class connection_pool_event
+  {
+    checkout,         // duration: time spent in get()
+    checkin,          // duration: time the connection was checked out
+    timeout,          // duration: time spent in get() before giving up
+    connect,          // duration: time spent opening the connection
+    connect_failure,  // duration: time spent trying to open the connection
+    close,            // duration: lifetime of the connection
+  };
+
+  inline auto to_string_view(connection_pool_event event) -> std::string_view
+  {
+    switch (event)
+    {
+      case connection_pool_event::checkout:
+        return "checkout";
+      case connection_pool_event::checkin:
+        return "checkin";
+      case connection_pool_event::timeout:
+        return "timeout";
+      case connection_pool_event::connect:
+        return "connect";
+      case connection_pool_event::connect_failure:
+        return "connect_failure";
+      case connection_pool_event::close:
+        return "close";
+    }
+    return "unknown";
+  }
+
+  // Counters maintained by each connection_pool, updated with relaxed atomics
+  struct connection_pool_counters_t
+  {
+    std::atomic<std::uint64_t> checkouts = 0;
+    std::atomic<std::uint64_t> timeouts = 0;
+    std::atomic<std::uint64_t> connections_created = 0;
+    std::atomic<std::uint64_t> connections_closed = 0;
+    std::atomic<std::uint64_t> connect_failures = 0;
+    latency_histogram_t wait_time;
+    latency_histogram_t checkout_duration;
+    latency_histogram_t connect_time;
+
+    auto record(connection_pool_event event, std::chrono::steady_clock::duration duration) -> void
+    {
+      switch (event)
+      {
+        case connection_pool_event::checkout:
+          checkouts.fetch_add(1, std::memory_order_relaxed);
+          wait_time.record(duration);
+          break;
+        case connection_pool_event::checkin:
+          checkout_duration.record(duration);
+          break;
+        case connection_pool_event::timeout:
+          timeouts.fetch_add(1, std::memory_order_relaxed);
+          wait_time.record(duration);
+          break;
+        case connection_pool_event::connect:
+          connections_created.fetch_add(1, std::memory_order_relaxed);
+          connect_time.record(duration);
+          break;
+        case connection_pool_event::connect_failure:
+          connect_failures.fetch_add(1, std::memory_order_relaxed);
+          break;
+        case connection_pool_event::close:
+          connections_closed.fetch_add(1, std::memory_order_relaxed);
+          break;
+      }
+    }
+  };
+
+  // Snapshot, see connection_pool::metrics()
+  struct connection_pool_metrics_t
+  {
+    std::size_t size = 0;  // open connections, including those being opened
+    std::size_t idle = 0;
+    std::size_t in_use = 0;
+    std::size_t waiting = 0;
+    std::size_t max_size = 0;
+    std::uint64_t checkouts = 0;
+    std::uint64_t timeouts = 0;
+    std::uint64_t connections_created = 0;
+    std::uint64_t connections_closed = 0;
+    std::uint64_t connect_failures = 0;
+    latency_histogram_t wait_time;
+    latency_histogram_t checkout_duration;
+    latency_histogram_t connect_time;
+
+    [[nodiscard]] auto utilization() const -> double
+    {
+      return max_size ? static_cast<double>(in_use) / static_cast<double>(max_size) : 0.0;
+    }
+  };
+
+  inline auto operator<<(std::ostream& os, const latency_histogram_t& histogram) -> std::ostream&
+  {
+    return os << "count=" << histogram.count() << " mean=" << histogram.mean().count()
+              << "us p50=" << histogram.percentile(50).count() << "us p99=" << histogram.percentile(99).count()
+              << "us";
+  }
+
+  inline auto operator<<(std::ostream& os, const connection_pool_metrics_t& metrics) -> std::ostream&
+  {
+    os << "size: " << metrics.size << '/' << metrics.max_size << ", in use: " << metrics.in_use
+       << ", idle: " << metrics.idle << ", waiting: " << metrics.waiting << '\n';
+    os << "checkouts: " << metrics.checkouts << ", timeouts: " << metrics.timeouts
+       << ", created: " << metrics.connections_created << ", closed: " << metrics.connections_closed
+       << ", connect failures: " << metrics.connect_failures << '\n';
+    os << "wait time: " << metrics.wait_time << '\n';
+    os << "checkout duration: " << metrics.checkout_duration << '\n';
+    os << "connect time: " << metrics.connect_time << '\n';
+    return os;
+  }
+}  // namespace sqlpp
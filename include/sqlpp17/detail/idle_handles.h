@@ -0,0 +1,192 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sqlpp17/detail/mpmc_queue.h>
+
+namespace sqlpp::detail
+{
+  // Idle connection handles (raw pointers): One slot per stripe, with threads mapped to stripes, backed by a shared
+  // lock-free queue. A thread usually gets back the handle it returned last, without touching shared cache lines.
+  template <typename Pointer>
+  class idle_handles_t
+  {
+    struct alignas(64) stripe_t
+    {
+      std::atomic<Pointer> handle = nullptr;
+    };
+
+    std::size_t _stripe_count;
+    std::unique_ptr<stripe_t[]> _stripes;
+    mpmc_queue_t<Pointer> _shared;
+    // The queue can hold all handles, but reports being full while a consumer has not released its cell yet
+    std::mutex _overflow_mutex;
+    std::vector<Pointer> _overflow;
+    std::atomic<std::size_t> _overflow_size = 0;
+
+    static auto thread_hash() -> std::size_t
+    {
+      thread_local const auto hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+      return hash;
+    }
+
+    auto own_stripe() -> stripe_t&
+    {
+      return _stripes[thread_hash() % _stripe_count];
+    }
+
+    auto push_shared(Pointer handle) -> void
+    {
+      if (_shared.try_push(handle))
+        return;
+      const auto lock = std::lock_guard{_overflow_mutex};
+      _overflow.push_back(handle);
+      _overflow_size.fetch_add(1, std::memory_order_release);
+    }
+
+  public:
+    // capacity is the maximum number of handles that may be idle at the same time
+    idle_handles_t(std::size_t capacity)
+        : _stripe_count(std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, std::max<std::size_t>(capacity, 1))),
+          _stripes(std::make_unique<stripe_t[]>(_stripe_count)),
+          _shared(capacity)
+    {
+      _overflow.reserve(capacity);
+    }
+    idle_handles_t(const idle_handles_t&) = delete;
+    idle_handles_t(idle_handles_t&&) = delete;
+    idle_handles_t& operator=(const idle_handles_t&) = delete;
+    idle_handles_t& operator=(idle_handles_t&&) = delete;
+    ~idle_handles_t() = default;
+
+    auto push(Pointer handle) -> void
+    {
+      auto expected = Pointer{nullptr};
+      if (own_stripe().handle.compare_exchange_strong(expected, handle, std::memory_order_acq_rel))
+        return;
+      push_shared(handle);
+    }
+
+    // Looks at the calling thread's stripe and the shared queue only
+    [[nodiscard]] auto try_pop(Pointer& handle) -> bool
+    {
+      if (auto* cached = own_stripe().handle.exchange(nullptr, std::memory_order_acq_rel))
+      {
+        handle = cached;
+        return true;
+      }
+      if (_shared.try_pop(handle))
+        return true;
+      if (_overflow_size.load(std::memory_order_acquire) == 0)
+        return false;
+      const auto lock = std::lock_guard{_overflow_mutex};
+      if (_overflow.empty())
+        return false;
+      handle = _overflow.back();
+      _overflow.pop_back();
+      _overflow_size.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    // Looks everywhere, slower
+    [[nodiscard]] auto try_pop_any(Pointer& handle) -> bool
+    {
+      if (try_pop(handle))
+        return true;
+      for (auto i = std::size_t{}; i < _stripe_count; ++i)
+      {
+        if (auto* cached = _stripes[i].handle.exchange(nullptr, std::memory_order_acq_rel))
+        {
+          handle = cached;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Takes out the handles for which select(handle) returns true, the others stay in their stripe or in the shared
+    // queue. Handles are only looked at while taken out, one at a time.
+    template <typename Select>
+    [[nodiscard]] auto take_if(Select&& select) -> std::vector<Pointer>
+    {
+      auto selected = std::vector<Pointer>{};
+      for (auto i = std::size_t{}; i < _stripe_count; ++i)
+      {
+        auto* handle = _stripes[i].handle.exchange(nullptr, std::memory_order_acq_rel);
+        if (not handle)
+          continue;
+        if (select(handle))
+        {
+          selected.push_back(handle);
+          continue;
+        }
+        auto expected = Pointer{nullptr};
+        if (not _stripes[i].handle.compare_exchange_strong(expected, handle, std::memory_order_acq_rel))
+          push_shared(handle);
+      }
+      // each handle that was in the shared queue is looked at once, the others go back to its end
+      for (auto n = _shared.size_hint(); n; --n)
+      {
+        auto handle = Pointer{nullptr};
+        if (not _shared.try_pop(handle))
+          break;
+        if (select(handle))
+          selected.push_back(handle);
+        else
+          push_shared(handle);
+      }
+      const auto lock = std::lock_guard{_overflow_mutex};
+      const auto kept = std::stable_partition(_overflow.begin(), _overflow.end(),
+                                              [&select](Pointer handle) { return not select(handle); });
+      selected.insert(selected.end(), kept, _overflow.end());
+      _overflow.erase(kept, _overflow.end());
+      _overflow_size.store(_overflow.size(), std::memory_order_release);
+      return selected;
+    }
+
+    // Exact only if there are no concurrent modifications
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      auto size = _shared.size_hint() + _overflow_size.load(std::memory_order_relaxed);
+      for (auto i = std::size_t{}; i < _stripe_count; ++i)
+      {
+        if (_stripes[i].handle.load(std::memory_order_relaxed))
+          ++size;
+      }
+      return size;
+    }
+  };
+}  // namespace sqlpp::detail
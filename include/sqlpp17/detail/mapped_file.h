@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sqlpp17/exception.h>
+
+namespace sqlpp::detail
+{
+  // Read-only mapping of a whole file, advice is passed to madvise()
+  class mapped_file_t
+  {
+    void* _data = MAP_FAILED;
+    std::size_t _size = 0;
+
+  public:
+    mapped_file_t(const std::string& path, int advice = MADV_NORMAL)
+    {
+      const auto fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+        throw ::sqlpp::exception("Could not open " + path + ": " + std::strerror(errno));
+      }
+
+      struct stat info = {};
+      if (::fstat(fd, &info) != 0)
+      {
+        const auto error = errno;
+        ::close(fd);
+        throw ::sqlpp::exception("Could not stat " + path + ": " + std::strerror(error));
+      }
+      _size = static_cast<std::size_t>(info.st_size);
+      if (_size)
+        _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      const auto error = errno;
+      ::close(fd);
+
+      if (_size and _data == MAP_FAILED)
+      {
+        throw ::sqlpp::exception("Could not map " + path + ": " + std::strerror(error));
+      }
+      if (_size)
+      {
+        ::madvise(_data, _size, advice);
+      }
+    }
+    mapped_file_t(const mapped_file_t&) = delete;
+    mapped_file_t(mapped_file_t&&) = delete;
+    mapped_file_t& operator=(const mapped_file_t&) = delete;
+    mapped_file_t& operator=(mapped_file_t&&) = delete;
+    ~mapped_file_t()
+    {
+      if (_data != MAP_FAILED)
+      {
+        ::munmap(_data, _size);
+      }
+    }
+
+    [[nodiscard]] auto data() const -> const unsigned char*
+    {
+      return static_cast<const unsigned char*>(_data);
+    }
+
+    [[nodiscard]] auto size() const
+    {
+      return _size;
+    }
+  };
+}  // namespace sqlpp::detail
@@ -0,0 +1,138 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace sqlpp::detail
+{
+  // Bounded lock-free multi-producer multi-consumer queue, see
+  // http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+  template <typename T>
+  class mpmc_queue_t
+  {
+    struct alignas(64) cell_t
+    {
+      std::atomic<std::size_t> sequence;
+      T data;
+    };
+
+    std::unique_ptr<cell_t[]> _cells;
+    std::size_t _mask;
+    alignas(64) std::atomic<std::size_t> _enqueue_pos = 0;
+    alignas(64) std::atomic<std::size_t> _dequeue_pos = 0;
+
+    static auto round_up(std::size_t n) -> std::size_t
+    {
+      auto capacity = std::size_t{2};
+      while (capacity < n)
+        capacity *= 2;
+      return capacity;
+    }
+
+  public:
+    mpmc_queue_t(std::size_t min_capacity)
+        : _cells(std::make_unique<cell_t[]>(round_up(min_capacity))), _mask(round_up(min_capacity) - 1)
+    {
+      for (auto i = std::size_t{}; i <= _mask; ++i)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mpmc_queue_t(const mpmc_queue_t&) = delete;
+    mpmc_queue_t(mpmc_queue_t&&) = delete;
+    mpmc_queue_t& operator=(const mpmc_queue_t&) = delete;
+    mpmc_queue_t& operator=(mpmc_queue_t&&) = delete;
+    ~mpmc_queue_t() = default;
+
+    // Returns false if the queue is full
+    [[nodiscard]] auto try_push(T value) -> bool
+    {
+      auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+      while (true)
+      {
+        auto& cell = _cells[pos & _mask];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+          if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            cell.data = std::move(value);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false;
+        }
+        else
+        {
+          pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    // Returns false if the queue is empty
+    [[nodiscard]] auto try_pop(T& value) -> bool
+    {
+      auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+      while (true)
+      {
+        auto& cell = _cells[pos & _mask];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0)
+        {
+          if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            value = std::move(cell.data);
+            cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false;
+        }
+        else
+        {
+          pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    // Exact only if there are no concurrent modifications
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      const auto enqueued = _enqueue_pos.load(std::memory_order_relaxed);
+      const auto dequeued = _dequeue_pos.load(std::memory_order_relaxed);
+      return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+  };
+}  // namespace sqlpp::detail
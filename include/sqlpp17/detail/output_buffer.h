@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+#include <sqlpp17/exception.h>
+
+namespace sqlpp::detail
+{
+  // Collects small writes and passes them to a stream or file descriptor in large blocks. Writes that do not fit
+  // into the buffer bypass it. Call flush() when done, the destructor does not write.
+  class output_buffer_t
+  {
+    static constexpr std::size_t _capacity = 64 * 1024;
+
+    std::ostream* _stream = nullptr;
+    int _fd = -1;
+    std::vector<char> _buffer = std::vector<char>(_capacity);
+    std::size_t _size = 0;
+
+    auto write(const char* data, std::size_t size) -> void
+    {
+      if (_stream)
+      {
+        _stream->write(data, static_cast<std::streamsize>(size));
+        if (not *_stream)
+        {
+          throw ::sqlpp::exception("Output buffer: Could not write to stream");
+        }
+        return;
+      }
+      while (size)
+      {
+        const auto written = ::write(_fd, data, size);
+        if (written < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw ::sqlpp::exception(std::string("Output buffer: Could not write to file descriptor: ") +
+                                   std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+      }
+    }
+
+    auto drain() -> void
+    {
+      if (_size)
+      {
+        write(_buffer.data(), _size);
+        _size = 0;
+      }
+    }
+
+  public:
+    explicit output_buffer_t(std::ostream& stream) : _stream(&stream)
+    {
+    }
+
+    explicit output_buffer_t(int fd) : _fd(fd)
+    {
+    }
+
+    auto append(std::string_view value) -> void
+    {
+      if (value.empty())
+      {
+        return;
+      }
+      if (value.size() > _capacity - _size)
+      {
+        drain();
+        if (value.size() >= _capacity)
+        {
+          write(value.data(), value.size());
+          return;
+        }
+      }
+      std::memcpy(_buffer.data() + _size, value.data(), value.size());
+      _size += value.size();
+    }
+
+    auto append(char value) -> void
+    {
+      if (_size == _capacity)
+      {
+        drain();
+      }
+      _buffer[_size++] = value;
+    }
+
+    template <typename T>
+    auto append_number(T value) -> void
+    {
+      char digits[64];
+      const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+      append(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));
+    }
+
+    auto flush() -> void
+    {
+      drain();
+      if (_stream)
+      {
+        _stream->flush();
+      }
+    }
+  };
+}  // namespace sqlpp::detail
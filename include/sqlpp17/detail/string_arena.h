@@ -0,0 +1,133 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sqlpp::detail
+{
+  // Bump allocator for strings: copies are appended to the current chunk, chunks grow geometrically and are
+  // released together. Moving the arena keeps all copies valid.
+  class string_arena_t
+  {
+    static constexpr std::size_t _initial_chunk_size = 4096;
+    static constexpr std::size_t _max_chunk_size = 1024 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    char* _next = nullptr;
+    std::size_t _available = 0;
+    std::size_t _next_chunk_size = _initial_chunk_size;
+    std::size_t _allocated = 0;
+
+    auto add_chunk(std::size_t chunk_size) -> void
+    {
+      _chunks.push_back(std::make_unique<char[]>(chunk_size));
+      _next = _chunks.back().get();
+      _available = chunk_size;
+      _allocated += chunk_size;
+    }
+
+    auto allocate(std::size_t size) -> char*
+    {
+      if (size > _available)
+      {
+        add_chunk(std::max(size, _next_chunk_size));
+        _next_chunk_size = std::min(_next_chunk_size * 2, _max_chunk_size);
+      }
+      auto* result = _next;
+      _next += size;
+      _available -= size;
+      return result;
+    }
+
+  public:
+    string_arena_t() = default;
+    string_arena_t(const string_arena_t&) = delete;
+    // The moved-from arena starts over with no chunks, its copies belong to the target now
+    string_arena_t(string_arena_t&& rhs) noexcept
+        : _chunks(std::move(rhs._chunks)),
+          _next(std::exchange(rhs._next, nullptr)),
+          _available(std::exchange(rhs._available, 0)),
+          _next_chunk_size(std::exchange(rhs._next_chunk_size, _initial_chunk_size)),
+          _allocated(std::exchange(rhs._allocated, 0))
+    {
+      rhs._chunks.clear();
+    }
+    string_arena_t& operator=(const string_arena_t&) = delete;
+    string_arena_t& operator=(string_arena_t&& rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        _chunks = std::move(rhs._chunks);
+        rhs._chunks.clear();
+        _next = std::exchange(rhs._next, nullptr);
+        _available = std::exchange(rhs._available, 0);
+        _next_chunk_size = std::exchange(rhs._next_chunk_size, _initial_chunk_size);
+        _allocated = std::exchange(rhs._allocated, 0);
+      }
+      return *this;
+    }
+    ~string_arena_t() = default;
+
+    // Makes sure that the next size bytes of copies fit into the current chunk
+    auto reserve(std::size_t size) -> void
+    {
+      if (size > _available)
+      {
+        add_chunk(size);
+      }
+    }
+
+    [[nodiscard]] auto copy(std::string_view value) -> std::string_view
+    {
+      if (value.empty())
+      {
+        return {};
+      }
+      auto* target = allocate(value.size());
+      std::memcpy(target, value.data(), value.size());
+      return {target, value.size()};
+    }
+
+    [[nodiscard]] auto chunk_count() const -> std::size_t
+    {
+      return _chunks.size();
+    }
+
+    // Bytes allocated for chunks, including unused space at the end of the current chunk
+    [[nodiscard]] auto allocated() const -> std::size_t
+    {
+      return _allocated;
+    }
+  };
+}  // namespace sqlpp::detail
@@ -0,0 +1,119 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace sqlpp::detail
+{
+  // Fixed number of threads executing tasks in FIFO order
+  class worker_pool_t
+  {
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::deque<std::function<void()>> _tasks;
+    bool _stopping = false;
+    std::vector<std::thread> _threads;
+
+    auto run() -> void
+    {
+      while (true)
+      {
+        auto task = std::function<void()>{};
+        {
+          auto lock = std::unique_lock{_mutex};
+          _wakeup.wait(lock, [this]() { return _stopping or not _tasks.empty(); });
+          if (_tasks.empty())
+            return;
+          task = std::move(_tasks.front());
+          _tasks.pop_front();
+        }
+        task();
+      }
+    }
+
+  public:
+    explicit worker_pool_t(std::size_t thread_count)
+    {
+      for (auto i = std::size_t{}; i < thread_count; ++i)
+      {
+        _threads.emplace_back([this]() { run(); });
+      }
+    }
+    worker_pool_t(const worker_pool_t&) = delete;
+    worker_pool_t(worker_pool_t&&) = delete;
+    worker_pool_t& operator=(const worker_pool_t&) = delete;
+    worker_pool_t& operator=(worker_pool_t&&) = delete;
+    // Finishes queued tasks
+    ~worker_pool_t()
+    {
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        _stopping = true;
+      }
+      _wakeup.notify_all();
+      for (auto& thread : _threads)
+      {
+        thread.join();
+      }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _threads.size();
+    }
+
+    // Runs the task inline if there are no threads
+    template <typename Task>
+    [[nodiscard]] auto submit(Task task) -> std::future<std::invoke_result_t<Task>>
+    {
+      // std::function requires copyable callables
+      auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<Task>()>>(std::move(task));
+      auto future = packaged->get_future();
+      if (_threads.empty())
+      {
+        (*packaged)();
+        return future;
+      }
+
+      {
+        const auto lock = std::scoped_lock{_mutex};
+        _tasks.emplace_back([packaged]() { (*packaged)(); });
+      }
+      _wakeup.notify_one();
+      return future;
+    }
+  };
+}  // namespace sqlpp::detail
@@ -46,7 +46,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     {                                                       \
       return CPP_NAME;                                      \
     }                                                       \
-  };
+  };                                                        \
+  /* access the member of the same name in any struct */    \
+  template <typename T>                                     \
+  static constexpr auto& _sqlpp_get(T& t)                   \
+  {                                                         \
+    return t.CPP_NAME;                                      \
+  }
 
 #define SQLPP_NAME_TAGS_FOR_SQL_AND_CPP(SQL_NAME, CPP_NAME) \
   struct _sqlpp_name_tag : public ::sqlpp::name_tag_base    \
@@ -26,13 +26,60 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <vector>
 
+#include <sqlpp17/result_row.h>
 #include <sqlpp17/type_traits.h>
 
 namespace sqlpp
 {
+  namespace detail
+  {
+    // Result handles may decode several rows at once via fetch_rows(rows, n), appending up to n owning rows
+    template <typename ResultHandle, typename Rows, typename = void>
+    inline constexpr auto has_fetch_rows_v = false;
+
+    template <typename ResultHandle, typename Rows>
+    inline constexpr auto has_fetch_rows_v<
+        ResultHandle,
+        Rows,
+        std::void_t<decltype(std::declval<ResultHandle&>().fetch_rows(std::declval<Rows&>(), std::size_t{}))>> = true;
+
+    // Result handles may decode the next row directly into a user-defined struct via read_next_row_into(target),
+    // returning false if there are no more rows
+    template <typename ResultHandle, typename Target, typename = void>
+    inline constexpr auto has_read_next_row_into_v = false;
+
+    template <typename ResultHandle, typename Target>
+    inline constexpr auto has_read_next_row_into_v<
+        ResultHandle,
+        Target,
+        std::void_t<decltype(std::declval<ResultHandle&>().read_next_row_into(std::declval<Target&>()))>> = true;
+
+    // Result handles that know the remaining number of rows or bytes of text (e.g. buffered results) provide
+    // size_hint() and byte_size_hint()
+    template <typename ResultHandle, typename = void>
+    inline constexpr auto has_size_hint_v = false;
+
+    template <typename ResultHandle>
+    inline constexpr auto
+        has_size_hint_v<ResultHandle, std::void_t<decltype(std::declval<const ResultHandle&>().size_hint())>> = true;
+
+    template <typename ResultHandle, typename = void>
+    inline constexpr auto has_byte_size_hint_v = false;
+
+    template <typename ResultHandle>
+    inline constexpr auto has_byte_size_hint_v<ResultHandle,
+                                               std::void_t<decltype(std::declval<const ResultHandle&>().byte_size_hint())>> =
+        true;
+  }  // namespace detail
+
   class result_end_t
   {
   };
@@ -43,6 +90,15 @@ namespace sqlpp
     using _row_t = typename ResultHandle::row_type;
     ResultHandle _handle;
 
+    template <typename Rows>
+    auto _reserve(Rows& rows, std::size_t n) const -> void
+    {
+      if (const auto hint = size_hint())
+      {
+        rows.reserve(rows.size() + std::min(n, *hint));
+      }
+    }
+
   public:
     result_t() = default;
 
@@ -81,20 +137,25 @@ namespace sqlpp
         return &_result._handle.row();
       }
 
-      [[nodiscard]] auto operator==(const iterator& rhs) const -> bool
+      // Non-template friends, so that the generic comparison operators in namespace sqlpp do not take over
+      [[nodiscard]] friend auto operator==(const iterator&, const iterator&) -> bool
       {
         return false;
       }
 
-      [[nodiscard]] auto operator==(const result_end_t& rhs) const -> bool
+      [[nodiscard]] friend auto operator==(const iterator& lhs, const result_end_t&) -> bool
+      {
+        return not lhs._result._handle;
+      }
+
+      [[nodiscard]] friend auto operator!=(const iterator& lhs, const iterator& rhs) -> bool
       {
-        return not _result._handle;
+        return not(lhs == rhs);
       }
 
-      template <typename T>
-      auto operator!=(const T& rhs) const -> bool
+      [[nodiscard]] friend auto operator!=(const iterator& lhs, const result_end_t& rhs) -> bool
       {
-        return not(operator==(rhs));
+        return not(lhs == rhs);
       }
 
       auto operator++() -> iterator&
@@ -136,6 +197,95 @@ namespace sqlpp
     {
       ++(begin());
     }
+
+    // Number of rows that have not been read yet, if known without reading them
+    [[nodiscard]] auto size_hint() const -> std::optional<std::size_t>
+    {
+      if constexpr (detail::has_size_hint_v<ResultHandle>)
+      {
+        return _handle.size_hint();
+      }
+      else
+      {
+        return std::nullopt;
+      }
+    }
+
+    // Total length of the text values in the rows that have not been read yet, if known without reading them
+    [[nodiscard]] auto byte_size_hint() const -> std::optional<std::size_t>
+    {
+      if constexpr (detail::has_byte_size_hint_v<ResultHandle>)
+      {
+        return _handle.byte_size_hint();
+      }
+      else
+      {
+        return std::nullopt;
+      }
+    }
+
+    // Returns up to n of the remaining rows as owning rows, i.e. text values are copied into std::string.
+    // The rows stay valid after the result is advanced or destroyed.
+    [[nodiscard]] auto fetch(std::size_t n) -> std::vector<owning_row_t<_row_t>>
+    {
+      auto rows = std::vector<owning_row_t<_row_t>>{};
+      if constexpr (detail::has_fetch_rows_v<ResultHandle, decltype(rows)>)
+      {
+        _handle.fetch_rows(rows, n);
+      }
+      else
+      {
+        _reserve(rows, n);
+        while (rows.size() < n and _handle)
+        {
+          _handle.get_next_row();
+          if (not _handle)
+          {
+            break;
+          }
+          rows.push_back(to_owning_row(_handle.row()));
+        }
+      }
+      return rows;
+    }
+
+    [[nodiscard]] auto fetch_all() -> std::vector<owning_row_t<_row_t>>
+    {
+      return fetch(std::numeric_limits<std::size_t>::max());
+    }
+
+    // Returns up to n of the remaining rows as T, a default constructible struct with one member per selected
+    // column, named like the column's member in result rows. Text members may be std::string.
+    template <typename T>
+    [[nodiscard]] auto as(std::size_t n = std::numeric_limits<std::size_t>::max()) -> std::vector<T>
+    {
+      auto rows = std::vector<T>{};
+      _reserve(rows, n);
+      while (rows.size() < n and _handle)
+      {
+        auto& target = rows.emplace_back();
+        if constexpr (detail::has_read_next_row_into_v<ResultHandle, T>)
+        {
+          if (not _handle.read_next_row_into(target))
+          {
+            rows.pop_back();
+          }
+        }
+        else
+        {
+          _handle.get_next_row();
+          if (_handle)
+          {
+            assign_row_to(_handle.row(), target);
+          }
+          else
+          {
+            rows.pop_back();
+          }
+        }
+      }
+      return rows;
+    }
   };
 
 }  // namespace sqlpp
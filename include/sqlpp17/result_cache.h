@@ -0,0 +1,500 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <sqlpp17/detail/mapped_file.h>
+#include <sqlpp17/detail/output_buffer.h>
+#include <sqlpp17/exception.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_columns.h>
+#include <sqlpp17/result_row.h>
+#include <sqlpp17/result_sink.h>
+
+// Result cache files hold the rows of one result_row_t type in columns, in native byte order:
+//   header:    "SQPC", u32 0x01020304 (byte order), u32 version, u32 column count, u64 row count, u64 reserved
+//   directory: per column: u8 binary_type, u8 nullable, u16 reserved, u32 name length, u64 name offset,
+//              u64 values offset, u64 nulls offset, u64 heap offset, u64 heap size
+//   sections:  names, then per column its values (fixed width numbers, u8 booleans, or row count + 1 u64 heap
+//              offsets for text), null bitmap (u64 words, bit set for NULL) and text heap, each 8 byte aligned
+namespace sqlpp::detail
+{
+  inline constexpr auto result_cache_magic = std::string_view{"SQPC"};
+  inline constexpr std::uint32_t result_cache_byte_order = 0x01020304;
+  inline constexpr std::uint32_t result_cache_version = 1;
+  inline constexpr std::size_t result_cache_header_size = 32;
+  inline constexpr std::size_t result_cache_entry_size = 48;
+
+  struct result_cache_column_t
+  {
+    std::uint8_t type = 0;
+    std::uint8_t nullable = 0;
+    std::uint32_t name_length = 0;
+    std::uint64_t name_offset = 0;
+    std::uint64_t values_offset = 0;
+    std::uint64_t nulls_offset = 0;
+    std::uint64_t heap_offset = 0;
+    std::uint64_t heap_size = 0;
+  };
+
+  inline auto align_to_8(std::uint64_t position) -> std::uint64_t
+  {
+    return (position + 7) / 8 * 8;
+  }
+
+  template <typename T>
+  auto append_raw(output_buffer_t& buffer, const T& value) -> void
+  {
+    buffer.append(std::string_view(reinterpret_cast<const char*>(&value), sizeof(T)));
+  }
+
+  inline auto append_padding(output_buffer_t& buffer, std::uint64_t size) -> void
+  {
+    static constexpr char zeros[8] = {};
+    buffer.append(std::string_view(zeros, align_to_8(size) - size));
+  }
+
+  template <typename T>
+  auto read_raw(const unsigned char* data) -> T
+  {
+    auto value = T{};
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  // Bytes per row in the values section, text columns hold row count + 1 offsets
+  template <typename ColumnSpec>
+  constexpr auto values_width() -> std::uint64_t
+  {
+    using _value_t = sink_value_t<ColumnSpec>;
+    if constexpr (std::is_same_v<_value_t, std::string_view>)
+      return sizeof(std::uint64_t);
+    else if constexpr (std::is_same_v<_value_t, bool>)
+      return 1;
+    else
+      return sizeof(_value_t);
+  }
+
+  template <typename ColumnSpec>
+  auto values_size(std::uint64_t row_count) -> std::uint64_t
+  {
+    if constexpr (std::is_same_v<sink_value_t<ColumnSpec>, std::string_view>)
+      return (row_count + 1) * values_width<ColumnSpec>();
+    else
+      return row_count * values_width<ColumnSpec>();
+  }
+
+  template <typename ColumnSpec, typename Columns>
+  auto column_data(const Columns& columns) -> const result_column_data_t<ColumnSpec>&
+  {
+    return static_cast<const member_t<ColumnSpec, result_column_data_t<ColumnSpec>>&>(columns)();
+  }
+
+  // Directory entry and section layout of one column, starting at position
+  template <typename ColumnSpec, typename Columns>
+  auto plan_column(const Columns& columns, result_cache_column_t& entry, std::uint64_t& position) -> void
+  {
+    const auto& data = column_data<ColumnSpec>(columns);
+    entry.type = static_cast<std::uint8_t>(binary_type_of<sink_value_t<ColumnSpec>>());
+    entry.nullable = ColumnSpec::can_be_null;
+    entry.values_offset = position;
+    position = align_to_8(position + values_size<ColumnSpec>(columns.size()));
+    if constexpr (ColumnSpec::can_be_null)
+    {
+      entry.nulls_offset = position;
+      position += data.nulls.words().size() * sizeof(std::uint64_t);
+    }
+    if constexpr (std::is_same_v<sink_value_t<ColumnSpec>, std::string_view>)
+    {
+      entry.heap_offset = position;
+      entry.heap_size = data.values.data().size();
+      position = align_to_8(position + entry.heap_size);
+    }
+  }
+
+  template <typename ColumnSpec, typename Columns>
+  auto write_column(output_buffer_t& buffer, const Columns& columns) -> void
+  {
+    const auto& data = column_data<ColumnSpec>(columns);
+    if constexpr (std::is_same_v<sink_value_t<ColumnSpec>, std::string_view>)
+    {
+      for (const auto offset : data.values.offsets())
+      {
+        append_raw(buffer, static_cast<std::uint64_t>(offset));
+      }
+    }
+    else
+    {
+      const auto& values = data.values;
+      const auto size = values.size() * sizeof(typename std::decay_t<decltype(values)>::value_type);
+      buffer.append(std::string_view(reinterpret_cast<const char*>(values.data()), size));
+      append_padding(buffer, size);
+    }
+    if constexpr (ColumnSpec::can_be_null)
+    {
+      for (const auto word : data.nulls.words())
+      {
+        append_raw(buffer, word);
+      }
+    }
+    if constexpr (std::is_same_v<sink_value_t<ColumnSpec>, std::string_view>)
+    {
+      buffer.append(data.values.data());
+      append_padding(buffer, data.values.data().size());
+    }
+  }
+
+  template <typename... ColumnSpecs>
+  auto write_result_cache(const result_columns_t<ColumnSpecs...>& columns, int fd) -> void
+  {
+    constexpr auto column_count = sizeof...(ColumnSpecs);
+    const auto names = std::array<std::string_view, column_count>{column_name<ColumnSpecs>()...};
+
+    auto entries = std::array<result_cache_column_t, column_count>{};
+    auto position = std::uint64_t{result_cache_header_size + column_count * result_cache_entry_size};
+    for (std::size_t i = 0; i < column_count; ++i)
+    {
+      entries[i].name_length = static_cast<std::uint32_t>(names[i].size());
+      entries[i].name_offset = position;
+      position += names[i].size();
+    }
+    const auto names_end = position;
+    position = align_to_8(position);
+    {
+      std::size_t index = 0;
+      (..., plan_column<ColumnSpecs>(columns, entries[index++], position));
+    }
+
+    auto buffer = output_buffer_t{fd};
+    buffer.append(result_cache_magic);
+    append_raw(buffer, result_cache_byte_order);
+    append_raw(buffer, result_cache_version);
+    append_raw(buffer, static_cast<std::uint32_t>(column_count));
+    append_raw(buffer, static_cast<std::uint64_t>(columns.size()));
+    append_raw(buffer, std::uint64_t{0});
+    for (const auto& entry : entries)
+    {
+      append_raw(buffer, entry.type);
+      append_raw(buffer, entry.nullable);
+      append_raw(buffer, std::uint16_t{0});
+      append_raw(buffer, entry.name_length);
+      append_raw(buffer, entry.name_offset);
+      append_raw(buffer, entry.values_offset);
+      append_raw(buffer, entry.nulls_offset);
+      append_raw(buffer, entry.heap_offset);
+      append_raw(buffer, entry.heap_size);
+    }
+    for (const auto& name : names)
+    {
+      buffer.append(name);
+    }
+    append_padding(buffer, names_end);
+    (..., write_column<ColumnSpecs>(buffer, columns));
+    buffer.flush();
+  }
+}  // namespace sqlpp::detail
+
+namespace sqlpp
+{
+  // Writes the remaining rows of the result to path and returns the number of rows. The file is written next to
+  // path and renamed when complete, so readers never see partial files.
+  template <typename ResultHandle>
+  auto write_result_cache(result_t<ResultHandle>& result, const std::string& path) -> std::size_t
+  {
+    const auto columns = to_columns(result);
+    const auto temporary_path = path + ".tmp";
+    const auto fd = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+      throw ::sqlpp::exception("Result cache: Could not open " + temporary_path + ": " + std::strerror(errno));
+    }
+    try
+    {
+      detail::write_result_cache(columns, fd);
+      if (::fsync(fd) != 0)
+      {
+        throw ::sqlpp::exception("Result cache: Could not sync " + temporary_path + ": " + std::strerror(errno));
+      }
+    }
+    catch (...)
+    {
+      ::close(fd);
+      ::unlink(temporary_path.c_str());
+      throw;
+    }
+    ::close(fd);
+    if (std::rename(temporary_path.c_str(), path.c_str()) != 0)
+    {
+      const auto error = errno;
+      ::unlink(temporary_path.c_str());
+      throw ::sqlpp::exception("Result cache: Could not rename " + temporary_path + ": " + std::strerror(error));
+    }
+    return columns.size();
+  }
+
+  template <typename Row>
+  class result_cache_t
+  {
+    static_assert(wrong<Row>, "Row must be a result_row_t<...>");
+  };
+
+  // Memory mapped result cache file. Rows are assembled on access, text values point into the mapping and stay
+  // valid as long as the cache exists.
+  template <typename... ColumnSpecs>
+  class result_cache_t<result_row_t<ColumnSpecs...>>
+  {
+    static constexpr auto _column_count = sizeof...(ColumnSpecs);
+
+    struct column_t
+    {
+      const unsigned char* values = nullptr;
+      const unsigned char* nulls = nullptr;
+      const char* heap = nullptr;
+    };
+
+    std::unique_ptr<detail::mapped_file_t> _file;
+    std::size_t _row_count = 0;
+    std::array<column_t, _column_count> _columns = {};
+
+    [[noreturn]] static auto fail(const std::string& path, const std::string& message) -> void
+    {
+      throw ::sqlpp::exception("Result cache: " + path + ": " + message);
+    }
+
+    template <typename ColumnSpec>
+    auto open_column(const std::string& path, std::size_t index) -> void
+    {
+      const auto* data = _file->data();
+      const auto size = _file->size();
+      const auto* entry = data + detail::result_cache_header_size + index * detail::result_cache_entry_size;
+
+      const auto type = detail::read_raw<std::uint8_t>(entry);
+      const auto nullable = detail::read_raw<std::uint8_t>(entry + 1);
+      const auto name_length = detail::read_raw<std::uint32_t>(entry + 4);
+      const auto name_offset = detail::read_raw<std::uint64_t>(entry + 8);
+      const auto values_offset = detail::read_raw<std::uint64_t>(entry + 16);
+      const auto nulls_offset = detail::read_raw<std::uint64_t>(entry + 24);
+      const auto heap_offset = detail::read_raw<std::uint64_t>(entry + 32);
+      const auto heap_size = detail::read_raw<std::uint64_t>(entry + 40);
+
+      const auto name = detail::column_name<ColumnSpec>();
+      if (name_offset > size or name_length > size - name_offset or
+          std::string_view(reinterpret_cast<const char*>(data + name_offset), name_length).compare(name) != 0)
+      {
+        fail(path, "Expected column " + std::string(name) + " at position " + std::to_string(index));
+      }
+      if (type != static_cast<std::uint8_t>(detail::binary_type_of<detail::sink_value_t<ColumnSpec>>()) or
+          nullable != ColumnSpec::can_be_null)
+      {
+        fail(path, "Column " + std::string(name) + " has a different type");
+      }
+
+      // The row count comes from the file, check it before multiplying so that it cannot wrap around
+      if (_row_count >= size / detail::values_width<ColumnSpec>())
+      {
+        fail(path, "Column " + std::string(name) + " exceeds the file");
+      }
+      const auto within_file = [size](std::uint64_t offset, std::uint64_t length) {
+        return offset <= size and length <= size - offset;
+      };
+      if (not within_file(values_offset, detail::values_size<ColumnSpec>(_row_count)) or
+          (nullable and not within_file(nulls_offset, (_row_count + 63) / 64 * sizeof(std::uint64_t))) or
+          not within_file(heap_offset, heap_size))
+      {
+        fail(path, "Column " + std::string(name) + " exceeds the file");
+      }
+
+      auto& column = _columns[index];
+      column.values = data + values_offset;
+      column.nulls = nullable ? data + nulls_offset : nullptr;
+      column.heap = reinterpret_cast<const char*>(data + heap_offset);
+
+      // Text offsets are checked once, so that rows can be read without checks
+      if constexpr (std::is_same_v<detail::sink_value_t<ColumnSpec>, std::string_view>)
+      {
+        auto previous = std::uint64_t{0};
+        for (std::size_t row = 0; row <= _row_count; ++row)
+        {
+          const auto offset = detail::read_raw<std::uint64_t>(column.values + row * sizeof(std::uint64_t));
+          if ((row == 0 and offset != 0) or offset < previous or offset > heap_size)
+          {
+            fail(path, "Column " + std::string(name) + " has invalid text offsets");
+          }
+          previous = offset;
+        }
+      }
+    }
+
+    template <typename ColumnSpec>
+    auto read_value(std::size_t index, std::size_t row) const -> result_column_value_t<ColumnSpec>
+    {
+      using _value_t = detail::sink_value_t<ColumnSpec>;
+      const auto& column = _columns[index];
+      if constexpr (ColumnSpec::can_be_null)
+      {
+        const auto word = detail::read_raw<std::uint64_t>(column.nulls + row / 64 * sizeof(std::uint64_t));
+        if ((word >> (row % 64)) & 1u)
+        {
+          return std::nullopt;
+        }
+      }
+      if constexpr (std::is_same_v<_value_t, std::string_view>)
+      {
+        const auto begin = detail::read_raw<std::uint64_t>(column.values + row * sizeof(std::uint64_t));
+        const auto end = detail::read_raw<std::uint64_t>(column.values + (row + 1) * sizeof(std::uint64_t));
+        return std::string_view(column.heap + begin, end - begin);
+      }
+      else if constexpr (std::is_same_v<_value_t, bool>)
+      {
+        return column.values[row] != 0;
+      }
+      else
+      {
+        return detail::read_raw<_value_t>(column.values + row * sizeof(_value_t));
+      }
+    }
+
+    template <std::size_t... Is>
+    auto make_row(std::size_t row, std::index_sequence<Is...>) const -> result_row_t<ColumnSpecs...>
+    {
+      auto result = result_row_t<ColumnSpecs...>{};
+      (..., (static_cast<result_column_base<ColumnSpecs>&>(result)() = read_value<ColumnSpecs>(Is, row)));
+      return result;
+    }
+
+  public:
+    using row_type = result_row_t<ColumnSpecs...>;
+
+    explicit result_cache_t(const std::string& path)
+        : _file(std::make_unique<detail::mapped_file_t>(path, MADV_WILLNEED))
+    {
+      const auto* data = _file->data();
+      const auto size = _file->size();
+      if (size < detail::result_cache_header_size or
+          std::string_view(reinterpret_cast<const char*>(data), 4).compare(detail::result_cache_magic) != 0)
+      {
+        fail(path, "Not a result cache file");
+      }
+      if (detail::read_raw<std::uint32_t>(data + 4) != detail::result_cache_byte_order or
+          detail::read_raw<std::uint32_t>(data + 8) != detail::result_cache_version)
+      {
+        fail(path, "Unsupported byte order or version");
+      }
+      if (detail::read_raw<std::uint32_t>(data + 12) != _column_count or
+          size < detail::result_cache_header_size + _column_count * detail::result_cache_entry_size)
+      {
+        fail(path, "Expected " + std::to_string(_column_count) + " columns");
+      }
+      _row_count = static_cast<std::size_t>(detail::read_raw<std::uint64_t>(data + 16));
+      {
+        std::size_t index = 0;
+        (..., open_column<ColumnSpecs>(path, index++));
+      }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _row_count;
+    }
+
+    [[nodiscard]] auto empty() const -> bool
+    {
+      return _row_count == 0;
+    }
+
+    [[nodiscard]] auto operator[](std::size_t row) const -> row_type
+    {
+      return make_row(row, std::index_sequence_for<ColumnSpecs...>{});
+    }
+  };
+
+  // Result handle over a result cache, e.g. for sqlpp::result_t<result_cache_handle_t<Row>>{{cache}}
+  template <typename Row>
+  class result_cache_handle_t
+  {
+    const result_cache_t<Row>* _cache = nullptr;
+    std::size_t _next = 0;
+    Row _row;
+
+  public:
+    using row_type = Row;
+
+    result_cache_handle_t() = default;
+    result_cache_handle_t(const result_cache_t<Row>& cache) : _cache(&cache)
+    {
+    }
+
+    auto get_next_row() -> void
+    {
+      if (_cache and _next < _cache->size())
+      {
+        _row = (*_cache)[_next++];
+      }
+      else
+      {
+        _cache = nullptr;
+      }
+    }
+
+    [[nodiscard]] auto row() const -> const Row&
+    {
+      return _row;
+    }
+
+    [[nodiscard]] operator bool() const
+    {
+      return _cache != nullptr;
+    }
+
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      return _cache ? _cache->size() - _next : 0;
+    }
+  };
+
+  // Iterates the rows of the cache like a result from the database
+  template <typename Row>
+  [[nodiscard]] auto as_result(const result_cache_t<Row>& cache) -> result_t<result_cache_handle_t<Row>>
+  {
+    return result_t<result_cache_handle_t<Row>>{result_cache_handle_t<Row>{cache}};
+  }
+}  // namespace sqlpp
@@ -26,6 +26,7 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <optional>
 #include <utility>
 
 #include <sqlpp17/member.h>
@@ -35,15 +36,18 @@ namespace sqlpp::detail
   template <typename ColumnSpec>
   struct make_result_column_base
   {
-    using type = member_t<ColumnSpec,
-                          std::conditional_t<ColumnSpec::can_be_null,
-                                             std::optional<value_type_of_t<ColumnSpec>>,
-                                             value_type_of_t<ColumnSpec>>>;
+    using value_type = std::conditional_t<ColumnSpec::can_be_null,
+                                          std::optional<value_type_of_t<ColumnSpec>>,
+                                          value_type_of_t<ColumnSpec>>;
+    using type = member_t<ColumnSpec, value_type>;
   };
 }  // namespace sqlpp::detail
 
 namespace sqlpp
 {
+  template <typename ColumnSpec>
+  using result_column_value_t = typename detail::make_result_column_base<ColumnSpec>::value_type;
+
   template <typename ColumnSpec>
   using result_column_base = typename detail::make_result_column_base<ColumnSpec>::type;
 }  // namespace sqlpp
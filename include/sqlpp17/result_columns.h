@@ -0,0 +1,279 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <sqlpp17/member.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_row.h>
+#include <sqlpp17/type_traits.h>
+
+namespace sqlpp
+{
+  // One bit per row, set for NULL values
+  class null_bitmap_t
+  {
+    std::vector<std::uint64_t> _words;
+    std::size_t _size = 0;
+    std::size_t _null_count = 0;
+
+  public:
+    auto push_back(bool is_null) -> void
+    {
+      if (_size % 64 == 0)
+      {
+        _words.push_back(0);
+      }
+      if (is_null)
+      {
+        _words.back() |= std::uint64_t{1} << (_size % 64);
+        ++_null_count;
+      }
+      ++_size;
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+      _words.reserve((n + 63) / 64);
+    }
+
+    [[nodiscard]] auto is_null(std::size_t index) const -> bool
+    {
+      return (_words[index / 64] >> (index % 64)) & 1u;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _size;
+    }
+
+    [[nodiscard]] auto null_count() const -> std::size_t
+    {
+      return _null_count;
+    }
+
+    [[nodiscard]] auto words() const -> const std::vector<std::uint64_t>&
+    {
+      return _words;
+    }
+  };
+
+  // All strings of a column in one buffer, value i is data[offsets[i], offsets[i + 1])
+  class string_column_t
+  {
+    std::vector<std::size_t> _offsets = {0};
+    std::string _data;
+
+  public:
+    auto push_back(std::string_view value) -> void
+    {
+      _data.append(value);
+      _offsets.push_back(_data.size());
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+      _offsets.reserve(n + 1);
+    }
+
+    [[nodiscard]] auto operator[](std::size_t index) const -> std::string_view
+    {
+      return std::string_view(_data).substr(_offsets[index], _offsets[index + 1] - _offsets[index]);
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _offsets.size() - 1;
+    }
+
+    [[nodiscard]] auto offsets() const -> const std::vector<std::size_t>&
+    {
+      return _offsets;
+    }
+
+    [[nodiscard]] auto data() const -> const std::string&
+    {
+      return _data;
+    }
+  };
+
+  namespace detail
+  {
+    template <typename T>
+    struct column_values
+    {
+      using type = std::vector<T>;
+    };
+
+    // std::vector<bool> is not contiguous
+    template <>
+    struct column_values<bool>
+    {
+      using type = std::vector<std::uint8_t>;
+    };
+
+    template <>
+    struct column_values<std::string_view>
+    {
+      using type = string_column_t;
+    };
+  }  // namespace detail
+
+  template <typename T, bool CanBeNull>
+  struct column_data_t
+  {
+    typename detail::column_values<T>::type values;
+
+    auto push_back(const T& value) -> void
+    {
+      values.push_back(value);
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+      values.reserve(n);
+    }
+
+    [[nodiscard]] constexpr auto is_null(std::size_t) const -> bool
+    {
+      return false;
+    }
+  };
+
+  // NULL values are stored as default constructed values and flagged in the bitmap
+  template <typename T>
+  struct column_data_t<T, true>
+  {
+    typename detail::column_values<T>::type values;
+    null_bitmap_t nulls;
+
+    auto push_back(const std::optional<T>& value) -> void
+    {
+      values.push_back(value ? *value : T{});
+      nulls.push_back(not value);
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+      values.reserve(n);
+      nulls.reserve(n);
+    }
+
+    [[nodiscard]] auto is_null(std::size_t index) const -> bool
+    {
+      return nulls.is_null(index);
+    }
+  };
+
+  template <typename ColumnSpec>
+  using result_column_data_t =
+      column_data_t<remove_optional_t<result_column_value_t<ColumnSpec>>, ColumnSpec::can_be_null>;
+
+  // Struct of arrays: one member per selected column, named like the column in result rows
+  template <typename... ColumnSpecs>
+  class result_columns_t : public member_t<ColumnSpecs, result_column_data_t<ColumnSpecs>>...
+  {
+    std::size_t _size = 0;
+
+  public:
+    auto push_back(const result_row_t<ColumnSpecs...>& row) -> void
+    {
+      (..., (static_cast<member_t<ColumnSpecs, result_column_data_t<ColumnSpecs>>&>(*this)().push_back(
+                static_cast<const result_column_base<ColumnSpecs>&>(row)())));
+      ++_size;
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+      (..., static_cast<member_t<ColumnSpecs, result_column_data_t<ColumnSpecs>>&>(*this)().reserve(n));
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _size;
+    }
+
+    [[nodiscard]] auto empty() const -> bool
+    {
+      return _size == 0;
+    }
+  };
+
+  template <typename... ColumnSpecs>
+  inline constexpr auto column_count_v<result_columns_t<ColumnSpecs...>> = sizeof...(ColumnSpecs);
+
+  template <typename Row>
+  struct result_columns_of
+  {
+    static_assert(wrong<Row>, "Row must be a result_row_t<...>");
+  };
+
+  template <typename... ColumnSpecs>
+  struct result_columns_of<result_row_t<ColumnSpecs...>>
+  {
+    using type = result_columns_t<ColumnSpecs...>;
+  };
+
+  template <typename Row>
+  using result_columns_of_t = typename result_columns_of<Row>::type;
+
+  // Reads the remaining rows of the result into one contiguous vector per column
+  template <typename ResultHandle>
+  [[nodiscard]] auto to_columns(result_t<ResultHandle>& result)
+      -> result_columns_of_t<typename result_t<ResultHandle>::_row_t>
+  {
+    auto columns = result_columns_of_t<typename result_t<ResultHandle>::_row_t>{};
+    if (const auto hint = result.size_hint())
+    {
+      columns.reserve(*hint);
+    }
+    while (result._handle)
+    {
+      result._handle.get_next_row();
+      if (not result._handle)
+      {
+        break;
+      }
+      columns.push_back(result._handle.row());
+    }
+    return columns;
+  }
+
+  template <typename ResultHandle>
+  [[nodiscard]] auto to_columns(result_t<ResultHandle>&& result)
+      -> result_columns_of_t<typename result_t<ResultHandle>::_row_t>
+  {
+    return to_columns(result);
+  }
+}  // namespace sqlpp
@@ -26,6 +26,11 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
 #include <sqlpp17/result_column_base.h>
 
 namespace sqlpp
@@ -35,12 +40,93 @@ namespace sqlpp
   {
   };
 
+  // Rows of result_row_t may refer to memory owned by the result handle (e.g. text as std::string_view) and are
+  // overwritten by the next row. Owning rows hold copies of all values and can be kept around.
+  namespace detail
+  {
+    template <typename T>
+    struct owning_value
+    {
+      using type = T;
+    };
+
+    template <>
+    struct owning_value<std::string_view>
+    {
+      using type = std::string;
+    };
+
+    template <typename T>
+    struct owning_value<std::optional<T>>
+    {
+      using type = std::optional<typename owning_value<T>::type>;
+    };
+  }  // namespace detail
+
+  template <typename T>
+  using owning_value_t = typename detail::owning_value<T>::type;
+
+  template <typename ColumnSpec>
+  using owning_column_base = member_t<ColumnSpec, owning_value_t<result_column_value_t<ColumnSpec>>>;
+
+  template <typename... ColumnSpecs>
+  class owning_result_row_t : public owning_column_base<ColumnSpecs>...
+  {
+  };
+
+  template <typename Row>
+  struct owning_row
+  {
+    using type = Row;
+  };
+
+  template <typename... ColumnSpecs>
+  struct owning_row<result_row_t<ColumnSpecs...>>
+  {
+    using type = owning_result_row_t<ColumnSpecs...>;
+  };
+
+  template <typename Row>
+  using owning_row_t = typename owning_row<Row>::type;
+
+  template <typename Row>
+  [[nodiscard]] auto to_owning_row(const Row& row) -> owning_row_t<Row>
+  {
+    return row;
+  }
+
+  template <typename... ColumnSpecs>
+  [[nodiscard]] auto to_owning_row(const result_row_t<ColumnSpecs...>& row) -> owning_result_row_t<ColumnSpecs...>
+  {
+    auto result = owning_result_row_t<ColumnSpecs...>{};
+    (...,
+     (static_cast<owning_column_base<ColumnSpecs>&>(result)() =
+          owning_value_t<result_column_value_t<ColumnSpecs>>(static_cast<const result_column_base<ColumnSpecs>&>(row)())));
+    return result;
+  }
+
+  // User-defined structs receive column values in the member of the same name, see _sqlpp_get in name_tag.h
+  template <typename ColumnSpec, typename Target, typename Value>
+  auto assign_to_member(Target& target, Value&& value) -> void
+  {
+    name_tag_of_t<ColumnSpec>::_sqlpp_get(target) = std::forward<Value>(value);
+  }
+
+  template <typename Target, typename... ColumnSpecs>
+  auto assign_row_to(const result_row_t<ColumnSpecs...>& row, Target& target) -> void
+  {
+    (..., assign_to_member<ColumnSpecs>(target, static_cast<const result_column_base<ColumnSpecs>&>(row)()));
+  }
+
   template<typename T>
   inline constexpr auto column_count_v = 1;
 
   template <typename... ColumnSpecs>
   inline constexpr auto column_count_v<result_row_t<ColumnSpecs...>> = sizeof...(ColumnSpecs);
 
+  template <typename... ColumnSpecs>
+  inline constexpr auto column_count_v<owning_result_row_t<ColumnSpecs...>> = sizeof...(ColumnSpecs);
+
   template <typename... LeftColumnSpecs, typename... RightColumnSpecs>
   struct result_rows_are_compatible<result_row_t<LeftColumnSpecs...>, result_row_t<RightColumnSpecs...>>
   {
@@ -0,0 +1,592 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+
+#include <sqlpp17/detail/output_buffer.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_row.h>
+#include <sqlpp17/type_traits.h>
+
+namespace sqlpp
+{
+  struct csv_options_t
+  {
+    char delimiter = ',';
+    bool header = true;
+  };
+
+  // Type codes of the binary row format
+  enum class binary_type : std::uint8_t
+  {
+    boolean = 1,
+    int8,
+    int16,
+    int32,
+    int64,
+    uint8,
+    uint16,
+    uint32,
+    uint64,
+    float32,
+    float64,
+    text,
+  };
+
+  namespace detail
+  {
+    template <typename ColumnSpec>
+    using sink_value_t = remove_optional_t<result_column_value_t<ColumnSpec>>;
+
+    template <typename ColumnSpec>
+    constexpr auto column_name() -> std::string_view
+    {
+      return name_tag_of_t<ColumnSpec>::name;
+    }
+
+    template <typename Format, typename Buffer, typename... ColumnSpecs>
+    auto write_row(Format& format, Buffer& buffer, const result_row_t<ColumnSpecs...>& row) -> void
+    {
+      std::size_t index = 0;
+      format.begin_row(buffer);
+      (..., format.template write_field<ColumnSpecs>(buffer, index++,
+                                                      static_cast<const result_column_base<ColumnSpecs>&>(row)()));
+      format.end_row(buffer);
+    }
+
+    template <typename Format, typename... ColumnSpecs>
+    auto write_header(Format& format, output_buffer_t& buffer, const result_row_t<ColumnSpecs...>*) -> void
+    {
+      format.template write_header<ColumnSpecs...>(buffer);
+    }
+
+    template <typename Format, typename ResultHandle>
+    auto write_result(Format format, result_t<ResultHandle>& result, output_buffer_t buffer) -> std::size_t
+    {
+      write_header(format, buffer, static_cast<const typename result_t<ResultHandle>::_row_t*>(nullptr));
+      auto count = std::size_t{0};
+      for (const auto& row : result)
+      {
+        write_row(format, buffer, row);
+        ++count;
+      }
+      format.end(buffer);
+      buffer.flush();
+      return count;
+    }
+
+    // RFC 4180: fields containing delimiters, quotes or line breaks are quoted, quotes are doubled.
+    // NULL is written as an empty field.
+    class csv_format_t
+    {
+      csv_options_t _options;
+
+      auto write_text(output_buffer_t& buffer, std::string_view value) const -> void
+      {
+        if (value.find_first_of(std::string_view{"\"\r\n"}) == std::string_view::npos and
+            value.find(_options.delimiter) == std::string_view::npos)
+        {
+          buffer.append(value);
+          return;
+        }
+        buffer.append('"');
+        for (auto quote = value.find('"'); quote != std::string_view::npos; quote = value.find('"'))
+        {
+          buffer.append(value.substr(0, quote + 1));
+          buffer.append('"');
+          value.remove_prefix(quote + 1);
+        }
+        buffer.append(value);
+        buffer.append('"');
+      }
+
+      template <typename T>
+      auto write_value(output_buffer_t& buffer, const T& value) const -> void
+      {
+        if constexpr (std::is_same_v<T, std::string_view>)
+        {
+          write_text(buffer, value);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+          buffer.append(value ? std::string_view{"true"} : std::string_view{"false"});
+        }
+        else
+        {
+          buffer.append_number(value);
+        }
+      }
+
+    public:
+      csv_format_t(const csv_options_t& options) : _options(options)
+      {
+      }
+
+      template <typename... ColumnSpecs>
+      auto write_header(output_buffer_t& buffer) const -> void
+      {
+        if (_options.header)
+        {
+          std::size_t index = 0;
+          (..., (index++ ? buffer.append(_options.delimiter) : void(), write_text(buffer, column_name<ColumnSpecs>())));
+          buffer.append('\n');
+        }
+      }
+
+      auto begin_row(output_buffer_t&) const -> void
+      {
+      }
+
+      template <typename ColumnSpec, typename T>
+      auto write_field(output_buffer_t& buffer, std::size_t index, const T& value) const -> void
+      {
+        if (index)
+        {
+          buffer.append(_options.delimiter);
+        }
+        if constexpr (ColumnSpec::can_be_null)
+        {
+          if (value)
+          {
+            write_value(buffer, *value);
+          }
+        }
+        else
+        {
+          write_value(buffer, value);
+        }
+      }
+
+      auto end_row(output_buffer_t& buffer) const -> void
+      {
+        buffer.append('\n');
+      }
+
+      auto end(output_buffer_t&) const -> void
+      {
+      }
+    };
+
+    // One JSON object per line, keyed by column name. Non-finite floating point values are written as null.
+    class json_lines_format_t
+    {
+      static auto write_string(output_buffer_t& buffer, std::string_view value) -> void
+      {
+        static constexpr char hex[] = "0123456789abcdef";
+        buffer.append('"');
+        auto begin = std::size_t{0};
+        for (std::size_t i = 0; i < value.size(); ++i)
+        {
+          const auto c = static_cast<unsigned char>(value[i]);
+          if (c >= 0x20 and c != '"' and c != '\\')
+          {
+            continue;
+          }
+          buffer.append(value.substr(begin, i - begin));
+          begin = i + 1;
+          switch (c)
+          {
+            case '"':
+              buffer.append(std::string_view{"\\\""});
+              break;
+            case '\\':
+              buffer.append(std::string_view{"\\\\"});
+              break;
+            case '\n':
+              buffer.append(std::string_view{"\\n"});
+              break;
+            case '\r':
+              buffer.append(std::string_view{"\\r"});
+              break;
+            case '\t':
+              buffer.append(std::string_view{"\\t"});
+              break;
+            default:
+              buffer.append(std::string_view{"\\u00"});
+              buffer.append(hex[c >> 4]);
+              buffer.append(hex[c & 0xf]);
+          }
+        }
+        buffer.append(value.substr(begin));
+        buffer.append('"');
+      }
+
+      template <typename T>
+      static auto write_value(output_buffer_t& buffer, const T& value) -> void
+      {
+        if constexpr (std::is_same_v<T, std::string_view>)
+        {
+          write_string(buffer, value);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+          buffer.append(value ? std::string_view{"true"} : std::string_view{"false"});
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+          if (std::isfinite(value))
+          {
+            buffer.append_number(value);
+          }
+          else
+          {
+            buffer.append(std::string_view{"null"});
+          }
+        }
+        else
+        {
+          buffer.append_number(value);
+        }
+      }
+
+    public:
+      template <typename... ColumnSpecs>
+      auto write_header(output_buffer_t&) const -> void
+      {
+      }
+
+      auto begin_row(output_buffer_t& buffer) const -> void
+      {
+        buffer.append('{');
+      }
+
+      template <typename ColumnSpec, typename T>
+      auto write_field(output_buffer_t& buffer, std::size_t index, const T& value) const -> void
+      {
+        if (index)
+        {
+          buffer.append(',');
+        }
+        write_string(buffer, column_name<ColumnSpec>());
+        buffer.append(':');
+        if constexpr (ColumnSpec::can_be_null)
+        {
+          if (value)
+          {
+            write_value(buffer, *value);
+          }
+          else
+          {
+            buffer.append(std::string_view{"null"});
+          }
+        }
+        else
+        {
+          write_value(buffer, value);
+        }
+      }
+
+      auto end_row(output_buffer_t& buffer) const -> void
+      {
+        buffer.append(std::string_view{"}\n"});
+      }
+
+      auto end(output_buffer_t&) const -> void
+      {
+      }
+    };
+
+    template <typename T>
+    constexpr auto binary_type_of() -> binary_type
+    {
+      if constexpr (std::is_same_v<T, bool>)
+        return binary_type::boolean;
+      else if constexpr (std::is_same_v<T, std::string_view>)
+        return binary_type::text;
+      else if constexpr (std::is_same_v<T, float>)
+        return binary_type::float32;
+      else if constexpr (std::is_same_v<T, double>)
+        return binary_type::float64;
+      else if constexpr (std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) == 1)
+        return binary_type::int8;
+      else if constexpr (std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) == 2)
+        return binary_type::int16;
+      else if constexpr (std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) == 4)
+        return binary_type::int32;
+      else if constexpr (std::is_integral_v<T> and std::is_signed_v<T> and sizeof(T) == 8)
+        return binary_type::int64;
+      else if constexpr (std::is_integral_v<T> and sizeof(T) == 1)
+        return binary_type::uint8;
+      else if constexpr (std::is_integral_v<T> and sizeof(T) == 2)
+        return binary_type::uint16;
+      else if constexpr (std::is_integral_v<T> and sizeof(T) == 4)
+        return binary_type::uint32;
+      else if constexpr (std::is_integral_v<T> and sizeof(T) == 8)
+        return binary_type::uint64;
+      else
+        static_assert(wrong<T>, "No binary type for this result value type");
+    }
+
+    // Little endian, independent of the platform. Buffer is anything with append(std::string_view):
+    //   header: "SQPB", u32 column count, per column: u32 name length, name, u8 binary_type, u8 nullable
+    //   row:    u8 1 (0 marks the end of the stream), per column: [u8 is_null if nullable], value
+    //   value:  booleans as u8, numbers in their size, text as u32 length followed by the bytes
+    class binary_format_t
+    {
+      template <typename Buffer, typename Unsigned>
+      static auto write_unsigned(Buffer& buffer, Unsigned value) -> void
+      {
+        char bytes[sizeof(Unsigned)];
+        for (std::size_t i = 0; i < sizeof(Unsigned); ++i)
+        {
+          bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        buffer.append(std::string_view(bytes, sizeof(Unsigned)));
+      }
+
+      template <typename Buffer>
+      static auto write_text(Buffer& buffer, std::string_view value) -> void
+      {
+        if (value.size() > 0xffffffffu)
+        {
+          throw ::sqlpp::exception("Binary result format: Text exceeds 4 GiB");
+        }
+        write_unsigned(buffer, static_cast<std::uint32_t>(value.size()));
+        buffer.append(value);
+      }
+
+      template <typename Buffer, typename T>
+      static auto write_value(Buffer& buffer, const T& value) -> void
+      {
+        if constexpr (std::is_same_v<T, std::string_view>)
+        {
+          write_text(buffer, value);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+          write_unsigned(buffer, std::uint8_t{value});
+        }
+        else if constexpr (std::is_same_v<T, float>)
+        {
+          auto bits = std::uint32_t{};
+          std::memcpy(&bits, &value, sizeof(bits));
+          write_unsigned(buffer, bits);
+        }
+        else if constexpr (std::is_same_v<T, double>)
+        {
+          auto bits = std::uint64_t{};
+          std::memcpy(&bits, &value, sizeof(bits));
+          write_unsigned(buffer, bits);
+        }
+        else
+        {
+          write_unsigned(buffer, static_cast<std::make_unsigned_t<T>>(value));
+        }
+      }
+
+      template <typename Unsigned>
+      static auto read_unsigned(const char*& data, const char* end, Unsigned& value) -> bool
+      {
+        if (static_cast<std::size_t>(end - data) < sizeof(Unsigned))
+        {
+          return false;
+        }
+        value = 0;
+        for (std::size_t i = 0; i < sizeof(Unsigned); ++i)
+        {
+          value |= static_cast<Unsigned>(static_cast<Unsigned>(static_cast<unsigned char>(data[i])) << (8 * i));
+        }
+        data += sizeof(Unsigned);
+        return true;
+      }
+
+      template <typename T>
+      static auto read_value(const char*& data, const char* end, T& value) -> bool
+      {
+        if constexpr (std::is_same_v<T, std::string_view>)
+        {
+          auto size = std::uint32_t{};
+          if (not read_unsigned(data, end, size) or static_cast<std::size_t>(end - data) < size)
+          {
+            return false;
+          }
+          value = std::string_view(data, size);
+          data += size;
+          return true;
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+          auto byte = std::uint8_t{};
+          const auto complete = read_unsigned(data, end, byte);
+          value = byte != 0;
+          return complete;
+        }
+        else if constexpr (std::is_same_v<T, float> or std::is_same_v<T, double>)
+        {
+          auto bits = std::conditional_t<std::is_same_v<T, float>, std::uint32_t, std::uint64_t>{};
+          const auto complete = read_unsigned(data, end, bits);
+          std::memcpy(&value, &bits, sizeof(value));
+          return complete;
+        }
+        else
+        {
+          auto bits = std::make_unsigned_t<T>{};
+          const auto complete = read_unsigned(data, end, bits);
+          value = static_cast<T>(bits);
+          return complete;
+        }
+      }
+
+      template <typename ColumnSpec, typename T>
+      static auto read_field(const char*& data, const char* end, T& value) -> bool
+      {
+        if constexpr (ColumnSpec::can_be_null)
+        {
+          auto is_null = std::uint8_t{};
+          if (not read_unsigned(data, end, is_null))
+          {
+            return false;
+          }
+          if (is_null)
+          {
+            value.reset();
+            return true;
+          }
+          auto non_null = typename T::value_type{};
+          const auto complete = read_value(data, end, non_null);
+          value = non_null;
+          return complete;
+        }
+        else
+        {
+          return read_value(data, end, value);
+        }
+      }
+
+    public:
+      // Decodes a row written via write_row(), text values point into [data, end). Returns the end of the row, or
+      // nullptr if the row is incomplete.
+      template <typename... ColumnSpecs>
+      static auto read_row(const char* data, const char* end, result_row_t<ColumnSpecs...>& row) -> const char*
+      {
+        auto marker = std::uint8_t{};
+        if (not read_unsigned(data, end, marker))
+        {
+          return nullptr;
+        }
+        if (marker != 1)
+        {
+          throw ::sqlpp::exception("Binary result format: Expected a row");
+        }
+        const auto complete =
+            (true and ... and read_field<ColumnSpecs>(data, end, static_cast<result_column_base<ColumnSpecs>&>(row)()));
+        return complete ? data : nullptr;
+      }
+
+      template <typename... ColumnSpecs, typename Buffer>
+      auto write_header(Buffer& buffer) const -> void
+      {
+        buffer.append(std::string_view{"SQPB"});
+        write_unsigned(buffer, static_cast<std::uint32_t>(sizeof...(ColumnSpecs)));
+        (...,
+         (write_text(buffer, column_name<ColumnSpecs>()),
+          write_unsigned(buffer, static_cast<std::uint8_t>(binary_type_of<sink_value_t<ColumnSpecs>>())),
+          write_unsigned(buffer, std::uint8_t{ColumnSpecs::can_be_null})));
+      }
+
+      template <typename Buffer>
+      auto begin_row(Buffer& buffer) const -> void
+      {
+        write_unsigned(buffer, std::uint8_t{1});
+      }
+
+      template <typename ColumnSpec, typename Buffer, typename T>
+      auto write_field(Buffer& buffer, std::size_t, const T& value) const -> void
+      {
+        if constexpr (ColumnSpec::can_be_null)
+        {
+          write_unsigned(buffer, std::uint8_t{not value});
+          if (value)
+          {
+            write_value(buffer, *value);
+          }
+        }
+        else
+        {
+          write_value(buffer, value);
+        }
+      }
+
+      template <typename Buffer>
+      auto end_row(Buffer&) const -> void
+      {
+      }
+
+      template <typename Buffer>
+      auto end(Buffer& buffer) const -> void
+      {
+        write_unsigned(buffer, std::uint8_t{0});
+      }
+    };
+  }  // namespace detail
+
+  // Writers for the remaining rows of a result, returning the number of rows written. Column names and types are
+  // taken from the column specs. Output is buffered, large text values are passed through without copying.
+  template <typename ResultHandle>
+  auto write_csv(result_t<ResultHandle>& result, std::ostream& os, const csv_options_t& options = {}) -> std::size_t
+  {
+    return detail::write_result(detail::csv_format_t{options}, result, detail::output_buffer_t{os});
+  }
+
+  template <typename ResultHandle>
+  auto write_csv(result_t<ResultHandle>& result, int fd, const csv_options_t& options = {}) -> std::size_t
+  {
+    return detail::write_result(detail::csv_format_t{options}, result, detail::output_buffer_t{fd});
+  }
+
+  template <typename ResultHandle>
+  auto write_json_lines(result_t<ResultHandle>& result, std::ostream& os) -> std::size_t
+  {
+    return detail::write_result(detail::json_lines_format_t{}, result, detail::output_buffer_t{os});
+  }
+
+  template <typename ResultHandle>
+  auto write_json_lines(result_t<ResultHandle>& result, int fd) -> std::size_t
+  {
+    return detail::write_result(detail::json_lines_format_t{}, result, detail::output_buffer_t{fd});
+  }
+
+  template <typename ResultHandle>
+  auto write_binary(result_t<ResultHandle>& result, std::ostream& os) -> std::size_t
+  {
+    return detail::write_result(detail::binary_format_t{}, result, detail::output_buffer_t{os});
+  }
+
+  template <typename ResultHandle>
+  auto write_binary(result_t<ResultHandle>& result, int fd) -> std::size_t
+  {
+    return detail::write_result(detail::binary_format_t{}, result, detail::output_buffer_t{fd});
+  }
+}  // namespace sqlpp
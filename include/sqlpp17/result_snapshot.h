@@ -0,0 +1,162 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <sqlpp17/detail/string_arena.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_row.h>
+
+namespace sqlpp
+{
+  namespace detail
+  {
+    template <typename T>
+    auto copy_to_arena(string_arena_t&, T&) -> void
+    {
+    }
+
+    inline auto copy_to_arena(string_arena_t& arena, std::string_view& value) -> void
+    {
+      value = arena.copy(value);
+    }
+
+    inline auto copy_to_arena(string_arena_t& arena, std::optional<std::string_view>& value) -> void
+    {
+      if (value)
+      {
+        *value = arena.copy(*value);
+      }
+    }
+
+    template <typename... ColumnSpecs>
+    auto copy_row_to_arena(string_arena_t& arena, const result_row_t<ColumnSpecs...>& row) -> result_row_t<ColumnSpecs...>
+    {
+      auto result = row;
+      (..., copy_to_arena(arena, static_cast<result_column_base<ColumnSpecs>&>(result)()));
+      return result;
+    }
+  }  // namespace detail
+
+  // Rows that outlive their result: text values are copied into an arena owned by the snapshot, so a batch of
+  // rows needs a few chunk allocations instead of one allocation per string.
+  template <typename Row>
+  class result_snapshot_t
+  {
+    detail::string_arena_t _arena;
+    std::vector<Row> _rows;
+
+  public:
+    using value_type = Row;
+
+    result_snapshot_t() = default;
+    result_snapshot_t(const result_snapshot_t&) = delete;
+    result_snapshot_t(result_snapshot_t&& rhs) = default;
+    result_snapshot_t& operator=(const result_snapshot_t&) = delete;
+    result_snapshot_t& operator=(result_snapshot_t&& rhs) = default;
+    ~result_snapshot_t() = default;
+
+    auto reserve(std::size_t rows, std::size_t bytes) -> void
+    {
+      _rows.reserve(rows);
+      _arena.reserve(bytes);
+    }
+
+    auto push_back(const Row& row) -> void
+    {
+      _rows.push_back(detail::copy_row_to_arena(_arena, row));
+    }
+
+    [[nodiscard]] auto begin() const
+    {
+      return _rows.begin();
+    }
+
+    [[nodiscard]] auto end() const
+    {
+      return _rows.end();
+    }
+
+    [[nodiscard]] auto operator[](std::size_t index) const -> const Row&
+    {
+      return _rows[index];
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _rows.size();
+    }
+
+    [[nodiscard]] auto empty() const -> bool
+    {
+      return _rows.empty();
+    }
+
+    [[nodiscard]] auto arena() const -> const detail::string_arena_t&
+    {
+      return _arena;
+    }
+  };
+
+  // Copies up to n of the remaining rows of the result into a snapshot
+  template <typename ResultHandle>
+  [[nodiscard]] auto snapshot(result_t<ResultHandle>& result,
+                              std::size_t n = std::numeric_limits<std::size_t>::max())
+      -> result_snapshot_t<typename result_t<ResultHandle>::_row_t>
+  {
+    auto rows = result_snapshot_t<typename result_t<ResultHandle>::_row_t>{};
+    if (const auto hint = result.size_hint())
+    {
+      // The text length of a partial batch is not known, the arena grows as usual then
+      rows.reserve(std::min(n, *hint), *hint <= n ? result.byte_size_hint().value_or(0) : 0);
+    }
+    while (rows.size() < n and result._handle)
+    {
+      result._handle.get_next_row();
+      if (not result._handle)
+      {
+        break;
+      }
+      rows.push_back(result._handle.row());
+    }
+    return rows;
+  }
+
+  template <typename ResultHandle>
+  [[nodiscard]] auto snapshot(result_t<ResultHandle>&& result,
+                              std::size_t n = std::numeric_limits<std::size_t>::max())
+      -> result_snapshot_t<typename result_t<ResultHandle>::_row_t>
+  {
+    return snapshot(result, n);
+  }
+}  // namespace sqlpp
@@ -0,0 +1,458 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sqlpp17/clause/lock.h>
+#include <sqlpp17/connection_pool.h>
+#include <sqlpp17/exception.h>
+#include <sqlpp17/statement.h>
+#include <sqlpp17/transaction.h>
+#include <sqlpp17/type_traits.h>
+
+namespace sqlpp
+{
+  enum class routing_strategy
+  {
+    weighted_round_robin,
+    least_outstanding,  // fewest connections in use, relative to the weight
+  };
+
+  struct routing_pool_config_t
+  {
+    routing_strategy strategy = routing_strategy::weighted_round_robin;
+    // A replica is ejected after this many consecutive failures to hand out a connection
+    std::size_t max_failures = 3;
+    // Ejected replicas are tried again after this time
+    std::chrono::milliseconds ejection_time = std::chrono::seconds{10};
+    // Send reads to the primary if all replicas are ejected, otherwise throw
+    bool fallback_to_primary = true;
+  };
+
+  template <typename ConnectionConfig>
+  struct replica_config_t
+  {
+    connection_pool_config_t pool;
+    ConnectionConfig connection;
+    std::size_t weight = 1;
+  };
+
+  // Selects without locking clauses can be sent to a replica, everything else goes to the primary
+  template <typename Statement>
+  constexpr auto routes_to_replica_v = false;
+
+  template <typename... Clauses>
+  constexpr auto routes_to_replica_v<statement<Clauses...>> =
+      std::is_same_v<result_type_of_t<statement<Clauses...>>, select_result> and
+      not(std::is_same_v<Clauses, for_update_t> or ...) and not(std::is_same_v<Clauses, for_share_t> or ...);
+
+  namespace detail
+  {
+    struct outstanding_release_t
+    {
+      auto operator()(std::atomic<std::size_t>* outstanding) const noexcept -> void
+      {
+        --*outstanding;
+      }
+    };
+  }  // namespace detail
+
+  // A pooled connection, counted as outstanding for its replica until destroyed
+  template <typename Connection>
+  class routed_connection_t
+  {
+    Connection _connection;
+    std::unique_ptr<std::atomic<std::size_t>, detail::outstanding_release_t> _outstanding;
+
+  public:
+    routed_connection_t(Connection connection, std::atomic<std::size_t>* outstanding)
+        : _connection(std::move(connection)), _outstanding(outstanding)
+    {
+    }
+
+    [[nodiscard]] auto is_replica() const
+    {
+      return static_cast<bool>(_outstanding);
+    }
+
+    auto& get()
+    {
+      return _connection;
+    }
+
+    auto& operator*()
+    {
+      return _connection;
+    }
+
+    auto* operator->()
+    {
+      return &_connection;
+    }
+
+    template <typename Statement>
+    auto operator()(const Statement& statement)
+    {
+      return _connection(statement);
+    }
+  };
+
+  // The result of a select, keeping the connection that produced it
+  template <typename Connection, typename Result>
+  class routed_result_t
+  {
+    routed_connection_t<Connection> _connection;
+    Result _result;
+
+  public:
+    routed_result_t(routed_connection_t<Connection> connection, Result result)
+        : _connection(std::move(connection)), _result(std::move(result))
+    {
+    }
+
+    [[nodiscard]] auto is_from_replica() const
+    {
+      return _connection.is_replica();
+    }
+
+    auto begin()
+    {
+      return _result.begin();
+    }
+
+    auto end()
+    {
+      return _result.end();
+    }
+
+    auto& result()
+    {
+      return _result;
+    }
+  };
+
+  // A transaction on a primary connection. All statements executed through it go to the primary.
+  template <typename Connection>
+  class routed_transaction_t
+  {
+    Connection _connection;
+    transaction_t<Connection> _transaction;
+
+  public:
+    routed_transaction_t(Connection connection) : _connection(std::move(connection)), _transaction(_connection)
+    {
+    }
+    routed_transaction_t(const routed_transaction_t&) = delete;
+    routed_transaction_t(routed_transaction_t&&) = delete;  // the transaction refers to the connection
+    routed_transaction_t& operator=(const routed_transaction_t&) = delete;
+    routed_transaction_t& operator=(routed_transaction_t&&) = delete;
+    ~routed_transaction_t() = default;
+
+    template <typename Statement>
+    auto operator()(const Statement& statement)
+    {
+      return _connection(statement);
+    }
+
+    auto& connection()
+    {
+      return _connection;
+    }
+
+    auto commit() -> void
+    {
+      _transaction.commit();
+    }
+
+    auto rollback() -> void
+    {
+      _transaction.rollback();
+    }
+  };
+
+  // Sends statements to a primary pool or one of several replica pools.
+  // The route is determined at compile time from the statement type, see routes_to_replica_v.
+  template <typename Connector>
+  class routing_pool
+  {
+  public:
+    using pool_type = connection_pool<Connector>;
+    using config_type = typename Connector::config_type;
+    using connection_type = typename pool_type::connection_type;
+    using clock = std::chrono::steady_clock;
+
+  private:
+    struct replica_t
+    {
+      replica_config_t<config_type> config;
+      // Created in the constructor, or later if the replica was unreachable then
+      std::mutex pool_mutex;
+      std::unique_ptr<pool_type> owned_pool;
+      std::atomic<pool_type*> pool = nullptr;
+      std::size_t weight = 1;
+      std::atomic<std::size_t> outstanding = 0;
+      std::atomic<std::size_t> consecutive_failures = 0;
+      std::atomic<clock::rep> ejected_until = 0;
+
+      replica_t(const replica_config_t<config_type>& replica_config)
+          : config(replica_config), weight(replica_config.weight)
+      {
+      }
+    };
+
+    routing_pool_config_t _routing_config;
+    pool_type _primary;
+    std::vector<std::unique_ptr<replica_t>> _replicas;
+    std::size_t _total_weight = 0;
+    std::atomic<std::size_t> _next = 0;
+
+    [[nodiscard]] auto is_available(const replica_t& replica, clock::rep now) const
+    {
+      return replica.weight and replica.ejected_until.load(std::memory_order_relaxed) <= now;
+    }
+
+    // Returns _replicas.size() if no replica is available
+    [[nodiscard]] auto select_replica() -> std::size_t
+    {
+      const auto now = clock::now().time_since_epoch().count();
+      const auto ticket = _next++;
+
+      if (_routing_config.strategy == routing_strategy::weighted_round_robin)
+      {
+        // the ticket picks a slot in [0, total_weight), each replica owns weight slots
+        auto slot = ticket % _total_weight;
+        auto start = std::size_t{};
+        for (; start < _replicas.size() and slot >= _replicas[start]->weight; ++start)
+        {
+          slot -= _replicas[start]->weight;
+        }
+        for (auto i = std::size_t{}; i < _replicas.size(); ++i)
+        {
+          const auto index = (start + i) % _replicas.size();
+          if (is_available(*_replicas[index], now))
+            return index;
+        }
+        return _replicas.size();
+      }
+
+      // least outstanding, relative to weight, ties are broken by round robin
+      auto best = _replicas.size();
+      auto best_load = std::numeric_limits<double>::max();
+      for (auto i = std::size_t{}; i < _replicas.size(); ++i)
+      {
+        const auto index = (ticket + i) % _replicas.size();
+        const auto& replica = *_replicas[index];
+        if (not is_available(replica, now))
+          continue;
+        const auto load = static_cast<double>(replica.outstanding.load(std::memory_order_relaxed)) /
+                          static_cast<double>(replica.weight);
+        if (load < best_load)
+        {
+          best = index;
+          best_load = load;
+        }
+      }
+      return best;
+    }
+
+    auto record_failure(replica_t& replica) -> void
+    {
+      if (++replica.consecutive_failures >= _routing_config.max_failures)
+      {
+        eject(replica);
+      }
+    }
+
+    auto eject(replica_t& replica) -> void
+    {
+      replica.ejected_until = (clock::now() + _routing_config.ejection_time).time_since_epoch().count();
+    }
+
+    // Creates the replica's pool on first use, the replica is ejected if that fails
+    [[nodiscard]] auto pool_of(replica_t& replica) -> pool_type&
+    {
+      if (auto* pool = replica.pool.load(std::memory_order_acquire))
+        return *pool;
+
+      const auto lock = std::scoped_lock{replica.pool_mutex};
+      if (not replica.owned_pool)
+      {
+        try
+        {
+          replica.owned_pool = std::make_unique<pool_type>(replica.config.pool, replica.config.connection);
+        }
+        catch (const ::sqlpp::exception&)
+        {
+          eject(replica);
+          throw;
+        }
+        replica.pool.store(replica.owned_pool.get(), std::memory_order_release);
+      }
+      return *replica.owned_pool;
+    }
+
+  public:
+    routing_pool(const connection_pool_config_t& primary_pool_config,
+                 config_type primary_config,
+                 const std::vector<replica_config_t<config_type>>& replicas,
+                 const routing_pool_config_t& routing_config = {})
+        : _routing_config(routing_config), _primary(primary_pool_config, std::move(primary_config))
+    {
+      // An unreachable replica starts ejected instead of failing the whole pool
+      for (const auto& replica : replicas)
+      {
+        _replicas.push_back(std::make_unique<replica_t>(replica));
+        _total_weight += replica.weight;
+        try
+        {
+          [[maybe_unused]] auto& pool = pool_of(*_replicas.back());
+        }
+        catch (const ::sqlpp::exception&)
+        {
+        }
+      }
+    }
+    routing_pool(const routing_pool&) = delete;
+    routing_pool(routing_pool&&) = delete;
+    routing_pool& operator=(const routing_pool&) = delete;
+    routing_pool& operator=(routing_pool&&) = delete;
+    ~routing_pool() = default;
+
+    [[nodiscard]] auto primary() -> routed_connection_t<connection_type>
+    {
+      return {_primary.get(), nullptr};
+    }
+
+    // A connection to an available replica, or the primary if there is none (see fallback_to_primary)
+    [[nodiscard]] auto replica() -> routed_connection_t<connection_type>
+    {
+      for (auto attempt = std::size_t{}; attempt < _replicas.size(); ++attempt)
+      {
+        const auto index = _total_weight ? select_replica() : _replicas.size();
+        if (index >= _replicas.size())
+          break;
+
+        auto& replica = *_replicas[index];
+        try
+        {
+          auto connection = pool_of(replica).get();
+          replica.consecutive_failures = 0;
+          ++replica.outstanding;
+          return {std::move(connection), &replica.outstanding};
+        }
+        catch (const ::sqlpp::exception&)
+        {
+          record_failure(replica);
+        }
+      }
+
+      if (not _routing_config.fallback_to_primary)
+      {
+        throw ::sqlpp::exception("Routing pool: No replica available");
+      }
+      return primary();
+    }
+
+    // The connection a statement is routed to
+    template <typename Statement>
+    [[nodiscard]] auto get_for([[maybe_unused]] const Statement& statement) -> routed_connection_t<connection_type>
+    {
+      if constexpr (routes_to_replica_v<Statement>)
+      {
+        return replica();
+      }
+      else
+      {
+        return primary();
+      }
+    }
+
+    // Executes the statement on the connection it is routed to.
+    // Select results keep their connection until they are destroyed.
+    template <typename Statement>
+    auto operator()(const Statement& statement)
+    {
+      auto connection = get_for(statement);
+      if constexpr (std::is_same_v<result_type_of_t<Statement>, select_result>)
+      {
+        auto result = connection(statement);
+        return routed_result_t<connection_type, decltype(result)>{std::move(connection), std::move(result)};
+      }
+      else
+      {
+        return connection(statement);
+      }
+    }
+
+    // Statements within the transaction are executed by the primary
+    [[nodiscard]] auto start_transaction() -> routed_transaction_t<connection_type>
+    {
+      return routed_transaction_t<connection_type>{_primary.get()};
+    }
+
+    // Takes the replica out of rotation for ejection_time
+    auto eject(std::size_t index) -> void
+    {
+      eject(*_replicas.at(index));
+    }
+
+    [[nodiscard]] auto is_available(std::size_t index) const
+    {
+      return is_available(*_replicas.at(index), clock::now().time_since_epoch().count());
+    }
+
+    [[nodiscard]] auto outstanding(std::size_t index) const -> std::size_t
+    {
+      return _replicas.at(index)->outstanding;
+    }
+
+    [[nodiscard]] auto replica_count() const
+    {
+      return _replicas.size();
+    }
+
+    auto& primary_pool()
+    {
+      return _primary;
+    }
+
+    // Throws if the replica's pool cannot be created
+    auto& replica_pool(std::size_t index)
+    {
+      return pool_of(*_replicas.at(index));
+    }
+  };
+}  // namespace sqlpp
@@ -0,0 +1,348 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sqlpp17/connection_pool.h>
+#include <sqlpp17/detail/worker_pool.h>
+#include <sqlpp17/exception.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/type_traits.h>
+
+namespace sqlpp
+{
+  struct sharded_connections_config_t
+  {
+    // Used for each shard
+    connection_pool_config_t pool;
+    // Threads executing scattered statements, zero for one per shard
+    std::size_t parallelism = 0;
+  };
+
+  // Merge mode of scattered selects: all rows of the first shard, then all rows of the second, ...
+  struct concatenate_t
+  {
+  };
+
+  // Comparator for k-way merges of rows that are ordered by the column in each shard
+  template <typename Column, bool Descending = false>
+  struct merge_by_t
+  {
+    template <typename Row>
+    auto operator()(const Row& lhs, const Row& rhs) const -> bool
+    {
+      using _name_tag = name_tag_of_t<Column>;
+      const auto& l = _name_tag::_sqlpp_get(lhs);
+      const auto& r = _name_tag::_sqlpp_get(rhs);
+      // std::less, to avoid the expression operators in this namespace
+      return Descending ? std::less<>{}(r, l) : std::less<>{}(l, r);
+    }
+  };
+
+  template <typename Column>
+  auto merge_ascending(const Column&)
+  {
+    return merge_by_t<Column, false>{};
+  }
+
+  template <typename Column>
+  auto merge_descending(const Column&)
+  {
+    return merge_by_t<Column, true>{};
+  }
+
+  template <typename Connection, typename ShardResult>
+  struct shard_result_t
+  {
+    Connection connection;
+    ShardResult result;
+    bool has_row = false;
+  };
+
+  // Result handle for result_t, combining the results of several shards.
+  // Each shard's connection is kept until the result is destroyed.
+  template <typename Connection, typename ShardResult, typename Merge>
+  class sharded_result_handle_t
+  {
+  public:
+    using shard_t = shard_result_t<Connection, ShardResult>;
+    using row_type = typename ShardResult::_row_t;
+
+  private:
+    static constexpr auto _none = std::numeric_limits<std::size_t>::max();
+
+    std::vector<shard_t> _shards;
+    Merge _merge;
+    std::size_t _current = _none;
+    bool _started = false;
+
+    auto advance(shard_t& shard) -> void
+    {
+      shard.result._handle.get_next_row();
+      shard.has_row = static_cast<bool>(shard.result._handle);
+    }
+
+  public:
+    sharded_result_handle_t() = default;
+    sharded_result_handle_t(std::vector<shard_t> shards, Merge merge) : _shards(std::move(shards)), _merge(merge)
+    {
+    }
+
+    auto get_next_row() -> void
+    {
+      if constexpr (std::is_same_v<Merge, concatenate_t>)
+      {
+        // shards are advanced one after the other
+        auto index = _started ? _current : 0;
+        _started = true;
+        for (; index < _shards.size(); ++index)
+        {
+          advance(_shards[index]);
+          if (_shards[index].has_row)
+            break;
+        }
+        _current = index < _shards.size() ? index : _none;
+      }
+      else
+      {
+        // k-way merge: each shard holds its next row, the smallest is current
+        if (not _started)
+        {
+          _started = true;
+          for (auto& shard : _shards)
+          {
+            advance(shard);
+          }
+        }
+        else if (_current < _shards.size())
+        {
+          advance(_shards[_current]);
+        }
+
+        _current = _none;
+        for (auto index = std::size_t{}; index < _shards.size(); ++index)
+        {
+          if (_shards[index].has_row and
+              (_current == _none or
+               _merge(_shards[index].result._handle.row(), _shards[_current].result._handle.row())))
+          {
+            _current = index;
+          }
+        }
+      }
+    }
+
+    [[nodiscard]] auto row() const -> const row_type&
+    {
+      return _shards[_current].result._handle.row();
+    }
+
+    // Index of the shard of the current row
+    [[nodiscard]] auto shard() const -> std::size_t
+    {
+      return _current;
+    }
+
+    explicit operator bool() const
+    {
+      return _current < _shards.size();
+    }
+  };
+
+  // A connection pool per shard, a key-to-shard function, and parallel scatter/gather execution
+  template <typename Connector, typename Key>
+  class sharded_connections
+  {
+  public:
+    using pool_type = connection_pool<Connector>;
+    using config_type = typename Connector::config_type;
+    using connection_type = typename pool_type::connection_type;
+    using shard_function_type = std::function<std::size_t(const Key&)>;
+
+  private:
+    std::vector<std::unique_ptr<pool_type>> _pools;
+    shard_function_type _shard_of;
+    detail::worker_pool_t _workers;
+
+    // Waits for all tasks before reporting the first error, since tasks refer to the statement
+    template <typename T>
+    static auto wait_for_all(std::vector<std::future<T>>& futures)
+    {
+      auto results = std::conditional_t<std::is_void_v<T>, std::nullptr_t, std::vector<T>>{};
+      auto first_error = std::exception_ptr{};
+      for (auto& future : futures)
+      {
+        try
+        {
+          if constexpr (std::is_void_v<T>)
+          {
+            future.get();
+          }
+          else
+          {
+            results.push_back(future.get());
+          }
+        }
+        catch (...)
+        {
+          if (not first_error)
+            first_error = std::current_exception();
+        }
+      }
+      if (first_error)
+      {
+        std::rethrow_exception(first_error);
+      }
+      if constexpr (not std::is_void_v<T>)
+      {
+        return results;
+      }
+    }
+
+    // Executes the select on each connection in parallel and combines the results
+    template <typename Statement, typename Merge>
+    [[nodiscard]] auto make_result(std::vector<connection_type> connections, const Statement& statement, Merge merge)
+    {
+      using _shard_result_t = decltype(std::declval<connection_type&>()(statement));
+      using _handle_t = sharded_result_handle_t<connection_type, _shard_result_t, Merge>;
+      using _shard_t = typename _handle_t::shard_t;
+
+      auto futures = std::vector<std::future<_shard_t>>{};
+      futures.reserve(connections.size());
+      for (auto& connection : connections)
+      {
+        futures.push_back(_workers.submit([connection = std::move(connection), &statement]() mutable {
+          auto result = connection(statement);
+          return _shard_t{std::move(connection), std::move(result)};
+        }));
+      }
+      return ::sqlpp::result_t<_handle_t>{_handle_t{wait_for_all(futures), merge}};
+    }
+
+    [[nodiscard]] auto all_connections() -> std::vector<connection_type>
+    {
+      auto connections = std::vector<connection_type>{};
+      connections.reserve(_pools.size());
+      for (auto& pool : _pools)
+      {
+        connections.push_back(pool->get());
+      }
+      return connections;
+    }
+
+  public:
+    sharded_connections(const sharded_connections_config_t& config,
+                        const std::vector<config_type>& shard_configs,
+                        shard_function_type shard_of = [](const Key& key) { return std::hash<Key>{}(key); })
+        : _shard_of(std::move(shard_of)),
+          _workers(config.parallelism ? config.parallelism : shard_configs.size())
+    {
+      if (shard_configs.empty())
+      {
+        throw ::sqlpp::exception("Sharded connections: At least one shard is required");
+      }
+      for (const auto& shard_config : shard_configs)
+      {
+        _pools.push_back(std::make_unique<pool_type>(config.pool, shard_config));
+      }
+    }
+    sharded_connections(const sharded_connections&) = delete;
+    sharded_connections(sharded_connections&&) = delete;
+    sharded_connections& operator=(const sharded_connections&) = delete;
+    sharded_connections& operator=(sharded_connections&&) = delete;
+    ~sharded_connections() = default;
+
+    [[nodiscard]] auto shard_count() const -> std::size_t
+    {
+      return _pools.size();
+    }
+
+    [[nodiscard]] auto shard_of(const Key& key) const -> std::size_t
+    {
+      return _shard_of(key) % _pools.size();
+    }
+
+    auto& pool(std::size_t shard)
+    {
+      return *_pools.at(shard);
+    }
+
+    // A connection to the shard of the key
+    [[nodiscard]] auto get(const Key& key) -> connection_type
+    {
+      return pool(shard_of(key)).get();
+    }
+
+    // Executes the statement on the shard of the key.
+    // Select results are result_t objects that keep the connection until they are destroyed.
+    template <typename Statement>
+    auto operator()(const Key& key, const Statement& statement)
+    {
+      if constexpr (std::is_same_v<result_type_of_t<Statement>, select_result>)
+      {
+        auto connections = std::vector<connection_type>{};
+        connections.push_back(get(key));
+        return make_result(std::move(connections), statement, concatenate_t{});
+      }
+      else
+      {
+        return get(key)(statement);
+      }
+    }
+
+    // Executes the statement on all shards in parallel.
+    // Selects return a single result_t, combining the rows of all shards, either concatenated or, if each shard
+    // returns its rows ordered, merged via merge(lhs_row, rhs_row) -> bool, e.g. merge_ascending(tab.id).
+    // Other statements return a vector with the result of each shard, if any.
+    template <typename Statement, typename Merge = concatenate_t>
+    auto scatter(const Statement& statement, Merge merge = {})
+    {
+      if constexpr (std::is_same_v<result_type_of_t<Statement>, select_result>)
+      {
+        return make_result(all_connections(), statement, merge);
+      }
+      else
+      {
+        auto futures = std::vector<std::future<decltype(std::declval<connection_type&>()(statement))>>{};
+        for (auto& pool : _pools)
+        {
+          futures.push_back(_workers.submit([&pool, &statement]() { return pool->get()(statement); }));
+        }
+        return wait_for_all(futures);
+      }
+    }
+  };
+}  // namespace sqlpp
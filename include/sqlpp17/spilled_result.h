@@ -0,0 +1,370 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sqlpp17/detail/output_buffer.h>
+#include <sqlpp17/exception.h>
+#include <sqlpp17/result.h>
+#include <sqlpp17/result_row.h>
+#include <sqlpp17/result_sink.h>
+
+namespace sqlpp
+{
+  struct spill_config_t
+  {
+    // Encoded rows beyond this are written to a temporary file
+    std::size_t memory_limit = 64 * 1024 * 1024;
+    // Spilled rows are read back in blocks of this size, the following block is announced to the kernel ahead
+    std::size_t block_size = 1024 * 1024;
+    std::string directory = "/tmp";
+  };
+}  // namespace sqlpp
+
+namespace sqlpp::detail
+{
+  struct string_buffer_t
+  {
+    std::string& target;
+
+    auto append(std::string_view value) -> void
+    {
+      target.append(value);
+    }
+  };
+
+  // Temporary file that is unlinked right away, it disappears with the descriptor, even if the process dies
+  class spill_file_t
+  {
+    int _fd = -1;
+
+  public:
+    explicit spill_file_t(const std::string& directory)
+    {
+      auto path = directory + "/sqlpp17_spill_XXXXXX";
+      _fd = ::mkostemp(path.data(), O_CLOEXEC);
+      if (_fd < 0)
+      {
+        throw ::sqlpp::exception("Spilled result: Could not create a file in " + directory + ": " +
+                                 std::strerror(errno));
+      }
+      ::unlink(path.c_str());
+    }
+
+    spill_file_t(const spill_file_t&) = delete;
+    spill_file_t(spill_file_t&& rhs) noexcept : _fd(std::exchange(rhs._fd, -1))
+    {
+    }
+    spill_file_t& operator=(const spill_file_t&) = delete;
+    spill_file_t& operator=(spill_file_t&&) = delete;
+
+    ~spill_file_t()
+    {
+      if (_fd >= 0)
+      {
+        ::close(_fd);
+      }
+    }
+
+    [[nodiscard]] auto fd() const -> int
+    {
+      return _fd;
+    }
+  };
+}  // namespace sqlpp::detail
+
+namespace sqlpp
+{
+  // Rows in the compact encoding of the binary result format. Rows stay in memory up to the memory limit, all
+  // further rows go to a temporary file. Call finish() after the last push_back() and before reading.
+  template <typename Row>
+  class spilled_result_t
+  {
+    spill_config_t _config;
+    detail::binary_format_t _format;
+    std::string _memory;
+    std::optional<detail::spill_file_t> _file;
+    std::optional<detail::output_buffer_t> _output;
+    std::size_t _size = 0;
+
+  public:
+    explicit spilled_result_t(spill_config_t config = {}) : _config(std::move(config))
+    {
+    }
+
+    spilled_result_t(const spilled_result_t&) = delete;
+    spilled_result_t(spilled_result_t&&) = default;
+    spilled_result_t& operator=(const spilled_result_t&) = delete;
+    spilled_result_t& operator=(spilled_result_t&&) = default;
+    ~spilled_result_t() = default;
+
+    auto push_back(const Row& row) -> void
+    {
+      if (not _output)
+      {
+        const auto previous_size = _memory.size();
+        auto buffer = detail::string_buffer_t{_memory};
+        detail::write_row(_format, buffer, row);
+        if (_memory.size() <= _config.memory_limit)
+        {
+          ++_size;
+          return;
+        }
+        // Appending may have grown the capacity beyond the limit
+        _memory.resize(previous_size);
+        _memory.shrink_to_fit();
+        _file.emplace(_config.directory);
+        _output.emplace(_file->fd());
+      }
+      detail::write_row(_format, *_output, row);
+      ++_size;
+    }
+
+    auto finish() -> void
+    {
+      if (_output)
+      {
+        _output->flush();
+      }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _size;
+    }
+
+    [[nodiscard]] auto empty() const -> bool
+    {
+      return _size == 0;
+    }
+
+    [[nodiscard]] auto config() const -> const spill_config_t&
+    {
+      return _config;
+    }
+
+    [[nodiscard]] auto memory() const -> std::string_view
+    {
+      return _memory;
+    }
+
+    [[nodiscard]] auto is_spilled() const -> bool
+    {
+      return _file.has_value();
+    }
+
+    // File descriptor of the spill file, -1 if nothing was spilled
+    [[nodiscard]] auto spill_fd() const -> int
+    {
+      return _file ? _file->fd() : -1;
+    }
+
+    // Size of the spill file, complete after finish()
+    [[nodiscard]] auto spilled_bytes() const -> std::size_t
+    {
+      if (not _file)
+      {
+        return 0;
+      }
+      struct stat status;
+      if (::fstat(_file->fd(), &status) != 0)
+      {
+        throw ::sqlpp::exception(std::string("Spilled result: Could not stat the spill file: ") +
+                                 std::strerror(errno));
+      }
+      return static_cast<std::size_t>(status.st_size);
+    }
+  };
+
+  // Result handle over a spilled result, rows are read sequentially, first from memory, then from the file.
+  // Text values point into the handle's buffers and are valid until the next row is read.
+  template <typename Row>
+  class spilled_result_handle_t;
+
+  template <typename... ColumnSpecs>
+  class spilled_result_handle_t<result_row_t<ColumnSpecs...>>
+  {
+    using _row_t = result_row_t<ColumnSpecs...>;
+
+    const spilled_result_t<_row_t>* _result = nullptr;
+    const char* _next = nullptr;
+    const char* _end = nullptr;
+    bool _in_memory = true;
+    std::vector<char> _block;
+    std::size_t _block_size = 1;
+    std::size_t _file_offset = 0;
+    std::size_t _file_size = 0;
+    std::size_t _remaining = 0;
+    _row_t _row;
+
+    auto read_block() -> void
+    {
+      if (_in_memory)
+      {
+        if (_next != _end or not _result->is_spilled())
+        {
+          throw ::sqlpp::exception("Spilled result: Incomplete row in memory");
+        }
+        _in_memory = false;
+        _next = _end = nullptr;
+        _file_size = _result->spilled_bytes();
+        ::posix_fadvise(_result->spill_fd(), 0, 0, POSIX_FADV_SEQUENTIAL);
+      }
+      if (_file_offset >= _file_size)
+      {
+        throw ::sqlpp::exception("Spilled result: Truncated spill file");
+      }
+
+      // Keep the start of an incomplete row, grow the block if the row does not fit
+      const auto leftover = static_cast<std::size_t>(_end - _next);
+      if (leftover)
+      {
+        std::memmove(_block.data(), _next, leftover);
+      }
+      if (leftover >= _block.size())
+      {
+        _block.resize(std::max(_block_size, 2 * leftover));
+      }
+      const auto wanted = std::min(_block.size() - leftover, _file_size - _file_offset);
+      auto read = std::size_t{0};
+      while (read < wanted)
+      {
+        const auto result = ::pread(_result->spill_fd(), _block.data() + leftover + read, wanted - read,
+                                    static_cast<off_t>(_file_offset + read));
+        if (result < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          throw ::sqlpp::exception(std::string("Spilled result: Could not read the spill file: ") +
+                                   std::strerror(errno));
+        }
+        if (result == 0)
+        {
+          throw ::sqlpp::exception("Spilled result: Truncated spill file");
+        }
+        read += static_cast<std::size_t>(result);
+      }
+      _file_offset += read;
+      _next = _block.data();
+      _end = _next + leftover + read;
+      if (_file_offset < _file_size)
+      {
+        ::posix_fadvise(_result->spill_fd(), static_cast<off_t>(_file_offset), static_cast<off_t>(_block.size()),
+                        POSIX_FADV_WILLNEED);
+      }
+    }
+
+  public:
+    using row_type = _row_t;
+
+    spilled_result_handle_t() = default;
+    spilled_result_handle_t(const spilled_result_t<_row_t>& result)
+        : _result(&result),
+          _next(result.memory().data()),
+          _end(result.memory().data() + result.memory().size()),
+          _block_size(std::max(result.config().block_size, std::size_t{1})),
+          _remaining(result.size())
+    {
+    }
+
+    auto get_next_row() -> void
+    {
+      if (not _result or _remaining == 0)
+      {
+        _result = nullptr;
+        return;
+      }
+      while (true)
+      {
+        if (const auto row_end = detail::binary_format_t::read_row(_next, _end, _row))
+        {
+          _next = row_end;
+          --_remaining;
+          return;
+        }
+        read_block();
+      }
+    }
+
+    [[nodiscard]] auto row() const -> const _row_t&
+    {
+      return _row;
+    }
+
+    [[nodiscard]] operator bool() const
+    {
+      return _result != nullptr;
+    }
+
+    [[nodiscard]] auto size_hint() const -> std::size_t
+    {
+      return _result ? _remaining : 0;
+    }
+  };
+
+  // Iterates the rows like a result from the database, can be called repeatedly
+  template <typename Row>
+  [[nodiscard]] auto as_result(const spilled_result_t<Row>& result) -> result_t<spilled_result_handle_t<Row>>
+  {
+    return result_t<spilled_result_handle_t<Row>>{spilled_result_handle_t<Row>{result}};
+  }
+
+  // Reads the remaining rows of the result, spilling to disk beyond the memory limit
+  template <typename ResultHandle>
+  [[nodiscard]] auto materialize(result_t<ResultHandle>& result, spill_config_t config = {})
+      -> spilled_result_t<typename result_t<ResultHandle>::_row_t>
+  {
+    auto rows = spilled_result_t<typename result_t<ResultHandle>::_row_t>{std::move(config)};
+    for (const auto& row : result)
+    {
+      rows.push_back(row);
+    }
+    rows.finish();
+    return rows;
+  }
+
+  template <typename ResultHandle>
+  [[nodiscard]] auto materialize(result_t<ResultHandle>&& result, spill_config_t config = {})
+      -> spilled_result_t<typename result_t<ResultHandle>::_row_t>
+  {
+    return materialize(result, std::move(config));
+  }
+}  // namespace sqlpp
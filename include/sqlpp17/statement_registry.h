@@ -0,0 +1,112 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace sqlpp
+{
+  // Prepared statements of one physical connection, keyed by their SQL string.
+  // Pooled connections keep their registry while idle, so that every later borrower can reuse its statements.
+  // Handle owns the native statement, e.g. a unique_ptr. Not thread-safe, like the connection itself.
+  template <typename Handle>
+  class statement_registry_t
+  {
+    std::unordered_map<std::string, Handle> _statements;
+    std::size_t _hits = 0;
+    std::size_t _misses = 0;
+
+  public:
+    statement_registry_t() = default;
+    statement_registry_t(const statement_registry_t&) = delete;
+    statement_registry_t(statement_registry_t&&) = default;
+    statement_registry_t& operator=(const statement_registry_t&) = delete;
+    statement_registry_t& operator=(statement_registry_t&&) = default;
+    ~statement_registry_t() = default;
+
+    // Returns the statement registered for sql_string, calling prepare() -> Handle if there is none yet
+    template <typename Prepare>
+    auto get_or_prepare(const std::string& sql_string, Prepare&& prepare) -> Handle&
+    {
+      auto [it, inserted] = _statements.try_emplace(sql_string);
+      if (not inserted)
+      {
+        ++_hits;
+        return it->second;
+      }
+
+      ++_misses;
+      try
+      {
+        it->second = prepare();
+      }
+      catch (...)
+      {
+        _statements.erase(it);
+        throw;
+      }
+      return it->second;
+    }
+
+    auto erase(const std::string& sql_string) -> void
+    {
+      _statements.erase(sql_string);
+    }
+
+    auto clear() -> void
+    {
+      _statements.clear();
+    }
+
+    // Calls f(Handle&) for each registered statement
+    template <typename F>
+    auto for_each(F&& f) -> void
+    {
+      // std::for_each, since iterator comparisons in namespace sqlpp would pick up sqlpp's operators
+      std::for_each(_statements.begin(), _statements.end(), [&f](auto& entry) { f(entry.second); });
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return _statements.size();
+    }
+
+    [[nodiscard]] auto hits() const -> std::size_t
+    {
+      return _hits;
+    }
+
+    // Number of statements prepared so far, including erased ones
+    [[nodiscard]] auto misses() const -> std::size_t
+    {
+      return _misses;
+    }
+  };
+}  // namespace sqlpp
@@ -26,10 +26,15 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <chrono>
 #include <iostream>
+#include <mutex>
 #include <random>
 #include <set>
 #include <thread>
+#include <vector>
+
+#include <sqlpp17/connection_pool.h>
 
 #include <sqlpp17/clause/create_table.h>
 #include <sqlpp17/clause/drop_table.h>
@@ -154,5 +159,88 @@ namespace sqlpp::test
       throw;
     }
   }
+
+  template <typename Pool>
+  auto test_bounded_capacity(Pool& pool) -> void
+  {
+    try
+    {
+      auto connections = std::vector<std::decay_t<decltype(pool.get())>>{};
+      for (auto i = std::size_t{}; i < pool.max_size(); ++i)
+      {
+        connections.push_back(pool.get());
+      }
+      if (pool.size() != pool.max_size())
+      {
+        throw std::logic_error("Pool size does not match the number of connections in use");
+      }
+
+      try
+      {
+        [[maybe_unused]] auto db = pool.get(std::chrono::milliseconds{10});
+        throw std::logic_error("Pool exceeded its maximum size");
+      }
+      catch (const ::sqlpp::connection_pool_timeout_exception&)
+      {
+      }
+
+      // A returned connection is reused instead of opening a new one
+      auto* handle = connections.back().get();
+      connections.pop_back();
+      auto db = pool.get(std::chrono::milliseconds{10});
+      if (db.get() != handle or pool.size() != pool.max_size())
+      {
+        throw std::logic_error("Pool did not reuse the returned connection");
+      }
+    }
+    catch (const std::exception& e)
+    {
+      std::cerr << "Exception in " << __func__ << "\n";
+      throw;
+    }
+  }
+
+  template <typename Pool>
+  auto test_fifo_waiters(Pool& pool) -> void
+  {
+    try
+    {
+      auto connections = std::vector<std::decay_t<decltype(pool.get())>>{};
+      for (auto i = std::size_t{}; i < pool.max_size(); ++i)
+      {
+        connections.push_back(pool.get());
+      }
+
+      // Waiters are queued one after the other, each returns its connection immediately
+      auto mutex = std::mutex{};
+      auto order = std::vector<int>{};
+      auto threads = std::vector<std::thread>{};
+      for (auto i = 0; i < 5; ++i)
+      {
+        threads.push_back(std::thread([i, &pool, &mutex, &order]() {
+          [[maybe_unused]] auto db = pool.get();
+          const auto lock = std::scoped_lock{mutex};
+          order.push_back(i);
+        }));
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+      }
+
+      connections.pop_back();
+      for (auto&& t : threads)
+      {
+        t.join();
+      }
+
+      if (order != std::vector<int>{0, 1, 2, 3, 4})
+      {
+        throw std::logic_error("Waiters were not served in FIFO order");
+      }
+    }
+    catch (const std::exception& e)
+    {
+      std::cerr << "Exception in " << __func__ << "\n";
+      throw;
+    }
+  }
 }
 
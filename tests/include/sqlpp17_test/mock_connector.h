@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+Copyright (c) 2019, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sqlpp17/connection.h>
+#include <sqlpp17/connection_pool.h>
+#include <sqlpp17/statement_registry.h>
+
+namespace sqlpp::test
+{
+  struct mock_connection_config_t
+  {
+    bool fail_to_connect = false;
+    bool fail_to_construct = false;  // the pooled connection throws when constructed
+    std::chrono::milliseconds connect_delay = {};
+    int id = 0;  // copied to the handle, e.g. to tell servers apart
+  };
+
+  struct mock_handle_t
+  {
+    bool alive = true;
+    int id = 0;
+  };
+
+  // Minimal pooled connection, for testing pools without a database
+  template <typename Pool>
+  class mock_pooled_connection : private ::sqlpp::pool_base<Pool>
+  {
+    std::unique_ptr<mock_handle_t> _handle;
+
+    friend Pool;
+
+    mock_pooled_connection(const mock_connection_config_t& config, std::unique_ptr<mock_handle_t>&& handle, Pool* pool)
+        : ::sqlpp::pool_base<Pool>{pool}, _handle{std::move(handle)}
+    {
+      if (config.fail_to_construct)
+      {
+        throw ::sqlpp::exception("Mock: could not construct connection");
+      }
+    }
+
+  public:
+    mock_pooled_connection(const mock_pooled_connection&) = delete;
+    mock_pooled_connection(mock_pooled_connection&&) = default;
+    mock_pooled_connection& operator=(const mock_pooled_connection&) = delete;
+    mock_pooled_connection& operator=(mock_pooled_connection&&) = default;
+    ~mock_pooled_connection()
+    {
+      if (this->_connection_pool and _handle)
+        this->_connection_pool->put(std::move(_handle), this->_pool_entry);
+    }
+
+    auto* get() const
+    {
+      return _handle.get();
+    }
+
+    // The "prepared statement" is the SQL string, stored in the registry of the physical connection
+    auto& prepare(const std::string& sql_string)
+    {
+      return statements().get_or_prepare(sql_string, [&sql_string]() { return sql_string; });
+    }
+
+    auto& statements()
+    {
+      return this->_pool_entry->statements;
+    }
+  };
+
+  struct mock_connector_t
+  {
+    using config_type = mock_connection_config_t;
+    using handle_type = std::unique_ptr<mock_handle_t>;
+    using statement_registry_type = ::sqlpp::statement_registry_t<std::string>;
+
+    template <typename Pool>
+    using connection_type = mock_pooled_connection<Pool>;
+
+    static inline std::atomic<int> connect_count = 0;
+    static inline std::atomic<int> is_alive_count = 0;
+
+    static auto connect(const config_type& config) -> handle_type
+    {
+      std::this_thread::sleep_for(config.connect_delay);
+      if (config.fail_to_connect)
+      {
+        throw ::sqlpp::exception("Mock: could not connect");
+      }
+      ++connect_count;
+      return std::make_unique<mock_handle_t>(mock_handle_t{true, config.id});
+    }
+
+    static auto is_alive(handle_type& handle) -> bool
+    {
+      ++is_alive_count;
+      return handle->alive;
+    }
+  };
+
+  // Opens connections for prewarming in one call, like the postgresql connector
+  struct mock_many_connector_t : mock_connector_t
+  {
+    static auto connect_many(const config_type& config, std::size_t count, std::vector<handle_type>& handles) -> void
+    {
+      for (auto i = std::size_t{}; i < count; ++i)
+      {
+        handles.push_back(connect(config));
+      }
+    }
+  };
+
+  using mock_connection_pool = ::sqlpp::connection_pool<mock_connector_t>;
+  using mock_many_connection_pool = ::sqlpp::connection_pool<mock_many_connector_t>;
+}  // namespace sqlpp::test
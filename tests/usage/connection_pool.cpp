@@ -0,0 +1,478 @@
+/*
+Copyright (c) 2018 - 2018, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <sqlpp17/detail/idle_handles.h>
+#include <sqlpp17/transaction.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sqlpp17_test/connection_pool_tests.h>
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/mock_connector.h>
+
+namespace
+{
+  using ::sqlpp::test::expect;
+
+  // Many threads checking out and returning connections concurrently
+  auto stress(std::size_t max_size, int thread_count, int iterations) -> void
+  {
+    auto pool = ::sqlpp::test::mock_connection_pool{max_size, {}};
+    auto in_use = std::atomic<std::size_t>{};
+    auto max_in_use = std::atomic<std::size_t>{};
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < thread_count; ++i)
+    {
+      threads.push_back(std::thread([&]() {
+        for (auto k = 0; k < iterations; ++k)
+        {
+          auto db = pool.get();
+          const auto current = ++in_use;
+          auto max = max_in_use.load();
+          while (current > max and not max_in_use.compare_exchange_weak(max, current))
+          {
+          }
+          --in_use;
+        }
+      }));
+    }
+    for (auto&& t : threads)
+    {
+      t.join();
+    }
+
+    expect(max_in_use <= max_size, "pool handed out more connections than max_size");
+    expect(pool.size() <= max_size, "pool opened more connections than max_size");
+    expect(pool.idle_size() == pool.size(), "expected all connections to be idle");
+  }
+}  // namespace
+
+int main()
+{
+  try
+  {
+    using ::sqlpp::test::mock_connector_t;
+
+    {
+      auto pool_config = ::sqlpp::connection_pool_config_t{2, 3};
+      pool_config.validate_after_idle = {};
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      expect(pool.size() == 2 and pool.idle_size() == 2, "expected min_size connections to be opened");
+
+      ::sqlpp::test::test_single_connection(pool);
+      ::sqlpp::test::test_bounded_capacity(pool);
+      ::sqlpp::test::test_fifo_waiters(pool);
+      expect(pool.size() == 3 and pool.idle_size() == 3, "expected all connections to be returned");
+      expect(mock_connector_t::connect_count == 3, "expected connections to be reused");
+
+      // Dead connections are replaced on checkout
+      {
+        auto db = pool.get();
+        db.get()->alive = false;
+      }
+      {
+        auto db = pool.get();
+        expect(db.get()->alive, "expected a live connection");
+        expect(mock_connector_t::connect_count == 4, "expected the dead connection to be replaced");
+      }
+      expect(pool.size() == 3, "replacing a dead connection must not change the pool size");
+    }
+
+    // Connections are only validated after being idle for validate_after_idle
+    {
+      auto pool_config = ::sqlpp::connection_pool_config_t{0, 1};
+      pool_config.validate_after_idle = std::chrono::milliseconds{50};
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      {
+        auto db = pool.get();
+        db.get()->alive = false;
+      }
+      {
+        auto db = pool.get();
+        expect(not db.get()->alive, "expected recently used connection not to be validated");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds{60});
+      {
+        auto db = pool.get();
+        expect(db.get()->alive, "expected idle connection to be validated");
+      }
+    }
+
+    // Connections are replaced after max_lifetime
+    {
+      auto pool_config = ::sqlpp::connection_pool_config_t{0, 1};
+      pool_config.max_lifetime = std::chrono::milliseconds{50};
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      const auto first = pool.get().get();
+      expect(pool.get().get() == first, "expected connection to be reused");
+      std::this_thread::sleep_for(std::chrono::milliseconds{60});
+      const auto count = mock_connector_t::connect_count.load();
+      [[maybe_unused]] auto db = pool.get();
+      expect(mock_connector_t::connect_count == count + 1, "expected expired connection to be replaced");
+    }
+
+    // Idle connections are reaped down to min_size, dead connections are replaced
+    {
+      auto pool_config = ::sqlpp::connection_pool_config_t{2, 5};
+      pool_config.max_idle_time = std::chrono::milliseconds{50};
+      pool_config.validate_after_idle = std::chrono::milliseconds{50};
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      {
+        auto connections = std::vector<::sqlpp::test::mock_connection_pool::connection_type>{};
+        for (auto i = 0; i < 5; ++i)
+        {
+          connections.push_back(pool.get());
+        }
+      }
+      const auto is_alive_count = mock_connector_t::is_alive_count.load();
+      pool.reap();
+      expect(pool.size() == 5, "expected recently used connections to be kept");
+      expect(mock_connector_t::is_alive_count == is_alive_count, "expected recently used connections not to be checked");
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{60});
+      pool.reap();
+      expect(pool.size() == 2 and pool.idle_size() == 2, "expected idle connections to be reaped down to min_size");
+
+      {
+        auto db = pool.get();
+        db.get()->alive = false;
+      }
+      // Connections are validated after validate_after_idle
+      std::this_thread::sleep_for(std::chrono::milliseconds{60});
+      const auto count = mock_connector_t::connect_count.load();
+      pool.reap();
+      expect(pool.size() == 2 and pool.idle_size() == 2, "expected dead connection to be replaced");
+      expect(mock_connector_t::connect_count == count + 1, "expected one new connection");
+    }
+
+    // The reaper thread does the same in the background
+    {
+      auto pool_config = ::sqlpp::connection_pool_config_t{1, 4};
+      pool_config.max_idle_time = std::chrono::milliseconds{20};
+      pool_config.reaper_interval = std::chrono::milliseconds{10};
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      {
+        auto db1 = pool.get();
+        auto db2 = pool.get();
+        auto db3 = pool.get();
+      }
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+      while (pool.size() > 1 and std::chrono::steady_clock::now() < deadline)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      }
+      expect(pool.size() == 1, "expected the reaper to close idle connections");
+    }
+
+    // Statement registries belong to the physical connection
+    {
+      auto pool_config = ::sqlpp::connection_pool_config_t{0, 1};
+      pool_config.validate_after_idle = {};
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      {
+        auto db = pool.get();
+        db.prepare("SELECT 1");
+      }
+      {
+        auto db = pool.get();
+        expect(db.statements().size() == 1, "expected the registry to be kept while idle");
+        db.prepare("SELECT 1");
+        expect(db.statements().hits() == 1 and db.statements().misses() == 1, "expected the statement to be reused");
+        db.get()->alive = false;
+      }
+      {
+        auto db = pool.get();
+        expect(db.statements().size() == 0, "expected a new connection to start with an empty registry");
+      }
+    }
+
+    // Nested leases in the same thread share the connection
+    {
+      auto pool = ::sqlpp::test::mock_connection_pool{2, {}};
+      using lease_t = ::sqlpp::connection_lease_t<::sqlpp::test::mock_connection_pool>;
+      {
+        auto outer = pool.lease();
+        {
+          auto inner = pool.lease(std::chrono::milliseconds{10});
+          expect(inner.get().get() == outer.get().get(), "expected nested leases to share the connection");
+          expect(lease_t::depth(pool) == 2, "expected two nested leases");
+        }
+        expect(pool.idle_size() == 0, "expected the connection to be kept by the outer lease");
+
+        // other threads get their own connection
+        auto* other = static_cast<::sqlpp::test::mock_handle_t*>(nullptr);
+        std::thread([&]() {
+          auto lease = pool.lease();
+          other = lease->get();
+        }).join();
+        expect(other != outer->get(), "expected another thread to lease another connection");
+      }
+      expect(lease_t::depth(pool) == 0, "expected no lease");
+      expect(pool.size() == 2 and pool.idle_size() == 2, "expected the connections to be returned");
+    }
+
+    // Metrics
+    {
+      auto events = std::array<std::atomic<int>, 6>{};
+      auto pool_config = ::sqlpp::connection_pool_config_t{1, 2};
+      pool_config.metrics_sink = [&events](::sqlpp::connection_pool_event event, auto) {
+        ++events[static_cast<std::size_t>(event)];
+      };
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, {}};
+      {
+        auto db1 = pool.get();
+        auto db2 = pool.get();
+        const auto metrics = pool.metrics();
+        expect(metrics.in_use == 2 and metrics.idle == 0 and metrics.utilization() == 1.0,
+               "expected both connections to be in use");
+        try
+        {
+          [[maybe_unused]] auto db3 = pool.get(std::chrono::milliseconds{5});
+          throw std::logic_error("expected a timeout");
+        }
+        catch (const ::sqlpp::connection_pool_timeout_exception&)
+        {
+        }
+      }
+
+      const auto metrics = pool.metrics();
+      expect(metrics.size == 2 and metrics.idle == 2 and metrics.in_use == 0, "expected idle connections");
+      expect(metrics.checkouts == 2 and metrics.timeouts == 1, "unexpected checkout count");
+      expect(metrics.connections_created == 2 and metrics.connections_closed == 0, "unexpected connection count");
+      expect(metrics.wait_time.count() == 3 and metrics.checkout_duration.count() == 2, "unexpected histograms");
+      expect(metrics.wait_time.percentile(100) >= std::chrono::milliseconds{5}, "expected the timeout to be recorded");
+
+      const auto count = [&events](::sqlpp::connection_pool_event event) {
+        return events[static_cast<std::size_t>(event)].load();
+      };
+      expect(count(::sqlpp::connection_pool_event::checkout) == 2 and
+                 count(::sqlpp::connection_pool_event::checkin) == 2 and
+                 count(::sqlpp::connection_pool_event::timeout) == 1 and
+                 count(::sqlpp::connection_pool_event::connect) == 2,
+             "expected events to be reported to the sink");
+
+      auto histogram = ::sqlpp::latency_histogram_t{};
+      histogram.record(std::chrono::microseconds{0});
+      histogram.record(std::chrono::microseconds{3});
+      histogram.record(std::chrono::milliseconds{1});
+      expect(histogram.count() == 3 and histogram.bucket(0) == 1 and histogram.bucket(2) == 1,
+             "unexpected histogram buckets");
+      expect(histogram.percentile(50) == std::chrono::microseconds{4} and
+                 histogram.percentile(100) == std::chrono::microseconds{1024},
+             "unexpected histogram percentiles");
+    }
+
+    // Failing connects do not use up capacity
+    {
+      auto config = ::sqlpp::test::mock_connection_config_t{};
+      config.fail_to_connect = true;
+      auto pool = ::sqlpp::test::mock_connection_pool{1, config};
+      for (auto i = 0; i < 3; ++i)
+      {
+        try
+        {
+          [[maybe_unused]] auto db = pool.get(std::chrono::milliseconds{10});
+          throw std::logic_error("expected connect to fail");
+        }
+        catch (const ::sqlpp::connection_pool_timeout_exception&)
+        {
+          throw std::logic_error("unexpected timeout");
+        }
+        catch (const ::sqlpp::exception&)
+        {
+        }
+      }
+      expect(pool.size() == 0, "failed connects must release their slot");
+    }
+
+    // Connections that fail to be constructed do not use up capacity either
+    {
+      auto config = ::sqlpp::test::mock_connection_config_t{};
+      config.fail_to_construct = true;
+      auto closed = std::atomic<int>{};
+      auto pool_config = ::sqlpp::connection_pool_config_t{0, 1};
+      pool_config.metrics_sink = [&closed](::sqlpp::connection_pool_event event, auto) {
+        if (event == ::sqlpp::connection_pool_event::close)
+          ++closed;
+      };
+      auto pool = ::sqlpp::test::mock_connection_pool{pool_config, config};
+      for (auto i = 0; i < 3; ++i)
+      {
+        try
+        {
+          [[maybe_unused]] auto db = pool.get(std::chrono::milliseconds{10});
+          throw std::logic_error("expected the connection to fail");
+        }
+        catch (const ::sqlpp::connection_pool_timeout_exception&)
+        {
+          throw std::logic_error("unexpected timeout");
+        }
+        catch (const ::sqlpp::exception&)
+        {
+        }
+      }
+      expect(pool.size() == 0, "failed connections must release their slot");
+      expect(closed == 3, "expected failed connections to be reported as closed");
+    }
+
+    // Connections are opened in parallel and warmed up
+    {
+      auto config = ::sqlpp::test::mock_connection_config_t{};
+      config.connect_delay = std::chrono::milliseconds{100};
+      auto mutex = std::mutex{};
+      auto warmed_up = std::set<::sqlpp::test::mock_handle_t*>{};
+      const auto start = std::chrono::steady_clock::now();
+      auto pool = ::sqlpp::test::mock_connection_pool{
+          ::sqlpp::connection_pool_config_t{8, 10, 8}, config, [&](auto& connection) {
+            const auto lock = std::scoped_lock{mutex};
+            warmed_up.insert(connection.get());
+          }};
+      expect(std::chrono::steady_clock::now() - start < std::chrono::milliseconds{500},
+             "expected connections to be opened in parallel");
+      expect(warmed_up.size() == 8, "expected each connection to be warmed up");
+      expect(pool.size() == 8 and pool.idle_size() == 8, "expected warmed up connections to be idle");
+
+      // prewarm is limited by max_size
+      pool.prewarm(5);
+      expect(pool.size() == 10 and pool.idle_size() == 10, "expected prewarm to stop at max_size");
+    }
+
+    // Startup fails if the minimum cannot be reached
+    {
+      auto config = ::sqlpp::test::mock_connection_config_t{};
+      config.fail_to_connect = true;
+      auto failed = false;
+      try
+      {
+        auto pool = ::sqlpp::test::mock_connection_pool{::sqlpp::connection_pool_config_t{4, 4}, config};
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed, "expected pool construction to fail");
+
+      // Failures in warm up are reported, too
+      failed = false;
+      try
+      {
+        auto pool = ::sqlpp::test::mock_connection_pool{::sqlpp::connection_pool_config_t{4, 4}, {},
+                                                        [](auto&) { throw ::sqlpp::exception("warm up failed"); }};
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed, "expected pool construction to fail in warm up");
+    }
+
+    // Prewarming via connect_many stops at the first failure and reports each failed connection
+    {
+      auto connect_failures = std::atomic<int>{};
+      auto pool_config = ::sqlpp::connection_pool_config_t{3, 3};
+      pool_config.metrics_sink = [&connect_failures](::sqlpp::connection_pool_event event, auto) {
+        if (event == ::sqlpp::connection_pool_event::connect_failure)
+          ++connect_failures;
+      };
+      auto failing_config = ::sqlpp::test::mock_connection_config_t{};
+      failing_config.fail_to_connect = true;
+      auto failed = false;
+      try
+      {
+        auto pool = ::sqlpp::test::mock_many_connection_pool{pool_config, failing_config};
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed and connect_failures == 3, "expected three connect failures");
+
+      auto warm_ups = 0;
+      failed = false;
+      try
+      {
+        auto pool = ::sqlpp::test::mock_many_connection_pool{pool_config, {}, [&warm_ups](auto&) {
+                                                               ++warm_ups;
+                                                               throw ::sqlpp::exception("warm up failed");
+                                                             }};
+      }
+      catch (const ::sqlpp::exception&)
+      {
+        failed = true;
+      }
+      expect(failed and warm_ups == 1, "expected warm up to stop after the first failure");
+    }
+
+    // Handles that do not fit into the stripes and the shared queue are kept, not dropped
+    {
+      auto handles = std::array<int, 6>{};
+      auto idle = ::sqlpp::detail::idle_handles_t<int*>{1};
+      for (auto& handle : handles)
+      {
+        idle.push(&handle);
+      }
+      expect(idle.size_hint() == handles.size(), "expected all handles to be idle");
+      auto popped = std::set<int*>{};
+      for (auto* handle = static_cast<int*>(nullptr); idle.try_pop_any(handle);)
+      {
+        popped.insert(handle);
+      }
+      expect(popped.size() == handles.size(), "expected all handles to be returned");
+    }
+
+    // Handles that are not taken stay where they are, e.g. in the stripe of the thread that returned them
+    {
+      auto handles = std::array<int, 8>{0, 1, 2, 3, 4, 5, 6, 7};
+      auto idle = ::sqlpp::detail::idle_handles_t<int*>{handles.size()};
+      for (auto& handle : handles)
+      {
+        idle.push(&handle);
+      }
+      const auto taken = idle.take_if([](const int* handle) { return *handle % 2; });
+      expect(taken.size() == 4 and std::all_of(taken.begin(), taken.end(), [](int* handle) { return *handle % 2; }),
+             "expected the odd handles to be taken");
+      expect(idle.size_hint() == 4, "expected the even handles to stay idle");
+      auto handle = static_cast<int*>(nullptr);
+      expect(idle.try_pop(handle) and handle == &handles[0], "expected the first handle to stay in its stripe");
+    }
+
+    stress(2, 8, 20000);
+    stress(64, 8, 20000);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,181 @@
+/*
+Copyright (c) 2018 - 2018, Roland Bock
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this
+   list of conditions and the following disclaimer in the documentation and/or
+   other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <sqlpp17/transaction.h>
+#include <sqlpp17/clause/delete_from.h>
+#include <sqlpp17/clause/select.h>
+#include <sqlpp17/routing_pool.h>
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <sqlpp17_test/expect.h>
+#include <sqlpp17_test/mock_connector.h>
+#include <sqlpp17_test/tables/TabDepartment.h>
+
+namespace
+{
+  using routing_pool = ::sqlpp::routing_pool<::sqlpp::test::mock_connector_t>;
+  using replica_config = ::sqlpp::replica_config_t<::sqlpp::test::mock_connection_config_t>;
+
+  using ::sqlpp::test::expect;
+
+  auto server(int id, bool fail_to_connect = false)
+  {
+    auto config = ::sqlpp::test::mock_connection_config_t{};
+    config.id = id;
+    config.fail_to_connect = fail_to_connect;
+    return config;
+  }
+
+  auto replica(int id, std::size_t weight, bool fail_to_connect = false)
+  {
+    return replica_config{::sqlpp::connection_pool_config_t{0, 10}, server(id, fail_to_connect), weight};
+  }
+
+  template <typename Connection>
+  auto id_of(Connection& connection)
+  {
+    return connection->get()->id;
+  }
+
+  const auto select_departments = sqlpp::select(::test::tabDepartment.id).from(::test::tabDepartment).unconditionally();
+  const auto delete_departments = sqlpp::delete_from(::test::tabDepartment).unconditionally();
+
+  static_assert(::sqlpp::routes_to_replica_v<std::decay_t<decltype(select_departments)>>);
+  static_assert(not ::sqlpp::routes_to_replica_v<std::decay_t<decltype(select_departments.for_update())>>);
+  static_assert(not ::sqlpp::routes_to_replica_v<std::decay_t<decltype(delete_departments)>>);
+}  // namespace
+
+int main()
+{
+  try
+  {
+    // Reads go to replicas, writes to the primary
+    {
+      auto pool = routing_pool{{0, 10}, server(0), {replica(1, 1), replica(2, 1)}};
+      auto read = pool.get_for(select_departments);
+      expect(read.is_replica() and id_of(read) != 0, "expected a select to be routed to a replica");
+      auto write = pool.get_for(delete_departments);
+      expect(not write.is_replica() and id_of(write) == 0, "expected a delete to be routed to the primary");
+      auto locking_read = pool.get_for(select_departments.for_update());
+      expect(not locking_read.is_replica(), "expected a select for update to be routed to the primary");
+    }
+
+    // Weighted round robin
+    {
+      auto pool = routing_pool{{0, 10}, server(0), {replica(1, 3), replica(2, 1)}};
+      auto counts = std::array<int, 3>{};
+      for (auto i = 0; i < 400; ++i)
+      {
+        auto connection = pool.replica();
+        ++counts.at(id_of(connection));
+      }
+      expect(counts[0] == 0 and counts[1] == 300 and counts[2] == 100, "expected reads to be distributed by weight");
+    }
+
+    // Least outstanding
+    {
+      auto pool = routing_pool{{0, 10}, server(0), {replica(1, 1), replica(2, 1)}, {::sqlpp::routing_strategy::least_outstanding}};
+      auto first = pool.replica();
+      auto second = pool.replica();
+      expect(id_of(first) != id_of(second), "expected the idle replica to be chosen");
+      expect(pool.outstanding(0) == 1 and pool.outstanding(1) == 1, "expected one outstanding connection each");
+      {
+        auto third = pool.replica();
+        auto fourth = pool.replica();
+        expect(id_of(third) != id_of(fourth), "expected load to be balanced");
+      }
+      {
+        auto released = std::move(first);
+      }
+      auto fifth = pool.replica();
+      expect(id_of(fifth) != id_of(second), "expected the replica with fewer connections to be chosen");
+      expect(pool.outstanding(0) + pool.outstanding(1) == 2, "expected outstanding connections to be counted");
+    }
+
+    // Unhealthy replicas are ejected
+    {
+      auto pool = routing_pool{{0, 10}, server(0), {replica(1, 1, true), replica(2, 1)}};
+      for (auto i = 0; i < 10; ++i)
+      {
+        auto connection = pool.replica();
+        expect(id_of(connection) == 2, "expected the healthy replica to be used");
+      }
+      expect(not pool.is_available(0) and pool.is_available(1), "expected the failing replica to be ejected");
+
+      pool.eject(1);
+      auto connection = pool.replica();
+      expect(not connection.is_replica() and id_of(connection) == 0, "expected a fallback to the primary");
+    }
+
+    // A replica that cannot be prewarmed starts ejected and is retried after the ejection time
+    {
+      auto unreachable = replica(1, 1, true);
+      unreachable.pool.min_size = 2;
+      auto routing_config = ::sqlpp::routing_pool_config_t{};
+      routing_config.ejection_time = std::chrono::milliseconds{20};
+      auto pool = routing_pool{{0, 10}, server(0), {unreachable, replica(2, 1)}, routing_config};
+      expect(not pool.is_available(0) and pool.is_available(1), "expected the unreachable replica to start ejected");
+      {
+        auto connection = pool.replica();
+        expect(id_of(connection) == 2, "expected the reachable replica to be used");
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{30});
+      expect(pool.is_available(0), "expected the ejection to end");
+      for (auto i = 0; i < 2; ++i)
+      {
+        auto connection = pool.replica();
+        expect(id_of(connection) == 2, "expected the reachable replica to be used");
+      }
+      expect(not pool.is_available(0), "expected the replica to be ejected again");
+    }
+
+    // Without fallback
+    {
+      auto routing_config = ::sqlpp::routing_pool_config_t{};
+      routing_config.fallback_to_primary = false;
+      auto pool = routing_pool{{0, 10}, server(0), {replica(1, 1, true)}, routing_config};
+      try
+      {
+        [[maybe_unused]] auto connection = pool.replica();
+        throw std::logic_error("expected no replica to be available");
+      }
+      catch (const ::sqlpp::exception&)
+      {
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << std::endl;
+    return 1;
+  }
+}